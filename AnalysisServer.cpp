@@ -0,0 +1,247 @@
+// AnalysisServer.cpp
+#include "AnalysisServer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+
+using namespace std;
+
+static const int MAX_CELLS = 1 << 20;  // largest board a request may name
+
+AnalysisServer::AnalysisServer(const ServerConfig& cfg) : m_cfg(cfg) {
+    m_cfg.batch = max(1, m_cfg.batch);
+    m_cfg.search.ponder = SearchConfig::PONDER_OFF;  // no opponent to wait for
+    int n = m_cfg.workers > 0 ? m_cfg.workers
+                              : max(1, static_cast<int>(thread::hardware_concurrency()));
+    m_workers.resize(n);
+    for (Worker& w : m_workers)
+        w.player.reset(new SmartPlayer("server", m_cfg.search));
+    for (Worker& w : m_workers)
+        w.thread = thread([this, &w] { run(w); });
+}
+
+AnalysisServer::~AnalysisServer() {
+    {
+        lock_guard<mutex> lock(m_queueMutex);
+        m_stopping = true;
+    }
+    m_queueCv.notify_all();
+    for (Worker& w : m_workers) w.thread.join();
+}
+
+bool AnalysisServer::handle(const string& line, const Reply& reply) {
+    Clock::time_point arrived = Clock::now();
+    istringstream in(line);
+    string cmd;
+    if (!(in >> cmd)) return true;  // blank line
+    if (cmd == "quit") return false;
+
+    if (cmd == "stats") {
+        ServerStats st = stats();
+        ostringstream out;
+        out << fixed << setprecision(2) << "stats requests " << st.requests
+            << " errors " << st.errors << " searches " << st.searches
+            << " p50 " << st.p50 << " p90 " << st.p90 << " p99 " << st.p99
+            << " max " << st.maxMs << " mean " << st.meanMs;
+        send(reply, out.str());
+        return true;
+    }
+
+    Request r;
+    string error = "unknown command " + cmd;
+    if (cmd == "analyze" && parse(in, r, error)) {
+        r.reply   = reply;
+        r.arrived = arrived;
+        {
+            lock_guard<mutex> lock(m_queueMutex);
+            m_queue.push_back(std::move(r));
+            m_unanswered++;
+        }
+        m_queueCv.notify_one();
+        return true;
+    }
+    {
+        lock_guard<mutex> lock(m_statsMutex);
+        m_errors++;
+    }
+    send(reply, "error " + (r.id.empty() ? string("-") : r.id) + " " + error);
+    return true;
+}
+
+// The rest of an analyze line: id, board, moves and limits
+bool AnalysisServer::parse(istringstream& in, Request& r, string& error) const {
+    string board, moves;
+    if (!(in >> r.id >> board >> moves)) {
+        error = "expected: analyze <id> <C>x<L>x<N> <moves>";
+        return false;
+    }
+    int cols, levels, N;
+    char tail;
+    if (sscanf(board.c_str(), "%dx%dx%d%c", &cols, &levels, &N, &tail) != 3
+        || cols < 1 || levels < 1 || N < 1 || cols > MAX_CELLS / levels) {
+        error = "bad board " + board;
+        return false;
+    }
+
+    r.scaf  = Scaffold(cols, levels, N);
+    r.N     = N;
+    r.color = RED;
+    size_t i = 0;
+    while (moves != "-" && i < moves.size()) {
+        int col = 0;
+        if (moves.find(',') == string::npos && cols <= 9) {
+            col = moves[i++] - '0';
+        } else {
+            size_t end = moves.find(',', i);
+            if (end == string::npos) end = moves.size();
+            col = atoi(moves.substr(i, end - i).c_str());
+            i = end + 1;
+        }
+        if (r.scaf.state() != PLAYING) {
+            error = "moves after the end of the game";
+            return false;
+        }
+        if (col < 1 || col > cols || !r.scaf.makeMove(col, r.color)) {
+            error = "illegal move in " + moves;
+            return false;
+        }
+        r.color = (r.color == RED ? BLACK : RED);
+    }
+    if (r.scaf.state() != PLAYING) {
+        error = "game is over";
+        return false;
+    }
+
+    bool limited = false;
+    string key;
+    while (in >> key) {
+        long long v;
+        if (!(in >> v) || v < 0) {
+            error = "bad value for " + key;
+            return false;
+        }
+        if      (key == "movetime") r.tc.moveTimeMs = static_cast<int>(min(v, 1LL << 30));
+        else if (key == "nodes")    r.tc.nodes      = v;
+        else if (key == "depth")    r.tc.depth      = static_cast<int>(min(v, 1LL << 30));
+        else {
+            error = "unknown limit " + key;
+            return false;
+        }
+        limited = true;
+    }
+    if (!limited) {
+        r.tc.moveTimeMs = m_cfg.search.moveTimeMs;
+        r.tc.nodes      = m_cfg.search.maxNodes;
+        r.tc.depth      = m_cfg.search.maxDepth;
+    }
+    return true;
+}
+
+// Same position, same side to move and same limits: one search answers both
+static bool sameSearch(const Scaffold& a, const Scaffold& b, int colorA, int colorB,
+                       const TimeControl& x, const TimeControl& y) {
+    return a.cols() == b.cols() && a.levels() == b.levels()
+        && a.connectN() == b.connectN() && a.hash() == b.hash()
+        && a.numberEmpty() == b.numberEmpty() && colorA == colorB
+        && x.moveTimeMs == y.moveTimeMs && x.nodes == y.nodes && x.depth == y.depth;
+}
+
+void AnalysisServer::run(Worker& w) {
+    vector<Request>    batch;
+    vector<SearchInfo> found;
+    for (;;) {
+        batch.clear();
+        {
+            unique_lock<mutex> lock(m_queueMutex);
+            m_queueCv.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+            if (m_queue.empty()) return;
+            batch.push_back(std::move(m_queue.front()));
+            m_queue.pop_front();
+            const int cols = batch[0].scaf.cols(), levels = batch[0].scaf.levels();
+            for (auto it = m_queue.begin();
+                 it != m_queue.end() && static_cast<int>(batch.size()) < m_cfg.batch;) {
+                if (it->scaf.cols() == cols && it->scaf.levels() == levels) {
+                    batch.push_back(std::move(*it));
+                    it = m_queue.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        found.resize(batch.size());
+        for (size_t i = 0; i < batch.size(); i++) {
+            const Request& r = batch[i];
+            size_t j = 0;
+            while (j < i && !sameSearch(batch[j].scaf, r.scaf, batch[j].color, r.color,
+                                        batch[j].tc, r.tc))
+                j++;
+            if (j < i) {
+                found[i] = found[j];
+            } else {
+                w.player->setTimeControl(r.tc);
+                w.player->chooseMove(r.scaf, r.N, r.color);
+                found[i] = w.player->lastSearch();
+                lock_guard<mutex> lock(m_statsMutex);
+                m_searches++;
+            }
+            answer(r, found[i]);
+        }
+        lock_guard<mutex> lock(m_queueMutex);
+        m_unanswered -= static_cast<int>(batch.size());
+        if (m_unanswered == 0) m_idleCv.notify_all();
+    }
+}
+
+void AnalysisServer::wait() {
+    unique_lock<mutex> lock(m_queueMutex);
+    m_idleCv.wait(lock, [this] { return m_unanswered == 0; });
+}
+
+void AnalysisServer::answer(const Request& r, const SearchInfo& info) {
+    double latency = chrono::duration<double, milli>(Clock::now() - r.arrived).count();
+    ostringstream out;
+    out << "bestmove " << r.id << ' ' << info.move << " score " << info.score
+        << " depth " << info.depth << " nodes " << info.nodes << fixed
+        << setprecision(2) << " ms " << info.ms << " latency " << latency;
+    if (info.fromBook)    out << " book";
+    else if (info.solved) out << " solved";
+    {
+        lock_guard<mutex> lock(m_statsMutex);
+        m_latencies.push_back(latency);
+    }
+    send(r.reply, out.str());
+}
+
+void AnalysisServer::send(const Reply& reply, const string& line) {
+    lock_guard<mutex> lock(m_replyMutex);
+    reply(line);
+}
+
+// Nearest-rank percentiles over every request answered so far
+ServerStats AnalysisServer::stats() const {
+    ServerStats st;
+    vector<double> ms;
+    {
+        lock_guard<mutex> lock(m_statsMutex);
+        ms          = m_latencies;
+        st.errors   = m_errors;
+        st.searches = m_searches;
+    }
+    st.requests = static_cast<long long>(ms.size()) + st.errors;
+    if (ms.empty()) return st;
+    sort(ms.begin(), ms.end());
+    auto rank = [&](double p) {
+        size_t k = static_cast<size_t>(ceil(p * ms.size()));
+        return ms[min(ms.size(), max<size_t>(k, 1)) - 1];
+    };
+    st.p50   = rank(0.50);
+    st.p90   = rank(0.90);
+    st.p99   = rank(0.99);
+    st.maxMs = ms.back();
+    double sum = 0;
+    for (double v : ms) sum += v;
+    st.meanMs = sum / ms.size();
+    return st;
+}
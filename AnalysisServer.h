@@ -0,0 +1,112 @@
+// AnalysisServer.h
+#ifndef ANALYSISSERVER_H
+#define ANALYSISSERVER_H
+
+#include "GameCore.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+//––– AnalysisServer: a resident engine answering position queries ––––––––
+// Requests and replies are text lines.  Replies carry the request's id and
+// may come back in a different order from the requests:
+//
+//   analyze <id> <C>x<L>x<N> <moves> [movetime <ms>] [nodes <n>] [depth <d>]
+//     -> bestmove <id> <col> score <s> depth <d> nodes <n> ms <search>
+//        latency <total> [book|solved]
+//     -> error <id> <reason>
+//   stats
+//     -> stats requests <n> errors <n> searches <n> p50 <ms> p90 <ms>
+//        p99 <ms> max <ms> mean <ms>
+//
+// <moves> are the columns played so far, RED first: digits on boards of up
+// to 9 columns ("4453"), comma separated on wider ones ("10,11,10"), or "-"
+// for the empty board.  Without limits a request gets the configured move
+// time; with any, the ones not given are off.  Latency is measured from the
+// arrival of the line to the reply, so it includes the time queued.
+//
+// Each worker keeps one SmartPlayer for as long as the server runs, so its
+// transposition table, opening book and solve database stay warm from one
+// request to the next.  A worker takes the oldest queued request together
+// with up to `batch` - 1 more on the same board: the batch runs without
+// switching board size, which would clear the table and rebuild the
+// solver, and the same position asked for more than once in a batch is
+// searched once.
+struct ServerConfig {
+    int          workers = 0;  // 0 = one per hardware thread
+    int          batch   = 8;  // most requests a worker takes at a time
+    SearchConfig search;       // for every worker; moveTimeMs is the default
+                               // per-request budget
+};
+
+struct ServerStats {
+    long long requests = 0, errors = 0;  // answered or refused so far
+    long long searches = 0;    // positions searched (duplicates in a batch once)
+    double    p50 = 0, p90 = 0, p99 = 0, maxMs = 0, meanMs = 0;  // latency
+};
+
+class AnalysisServer {
+  public:
+    // Receives one reply line, without the newline.  Calls are serialized
+    // but come from the workers' threads.
+    using Reply = std::function<void(const std::string&)>;
+
+    explicit AnalysisServer(const ServerConfig& cfg = ServerConfig());
+    // Answers every request already queued, then stops the workers
+    ~AnalysisServer();
+    AnalysisServer(const AnalysisServer&) = delete;
+    AnalysisServer& operator=(const AnalysisServer&) = delete;
+
+    // Take one request line; its reply goes to `reply` once it is ready.
+    // False for "quit", which the transport acts on.
+    bool handle(const std::string& line, const Reply& reply);
+    // Block until every request handed in so far has been answered
+    void wait();
+    ServerStats stats() const;
+    int workers() const { return static_cast<int>(m_workers.size()); }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request {
+        std::string id;
+        Scaffold    scaf{1, 1};
+        int         N = 0, color = 0;
+        TimeControl tc;
+        Reply       reply;
+        Clock::time_point arrived;
+    };
+
+    struct Worker {
+        std::unique_ptr<SmartPlayer> player;
+        std::thread                  thread;
+    };
+
+    bool parse(std::istringstream& in, Request& r, std::string& error) const;
+    void run(Worker& w);
+    void answer(const Request& r, const SearchInfo& info);
+    void send(const Reply& reply, const std::string& line);
+
+    ServerConfig             m_cfg;
+    std::vector<Worker>      m_workers;
+    std::deque<Request>      m_queue;
+    std::mutex               m_queueMutex;
+    std::condition_variable  m_queueCv;
+    bool                     m_stopping = false;
+    int                      m_unanswered = 0;  // queued or being searched
+    std::condition_variable  m_idleCv;
+
+    std::mutex               m_replyMutex;
+    mutable std::mutex       m_statsMutex;
+    std::vector<double>      m_latencies;  // ms, one per answered request
+    long long                m_errors = 0, m_searches = 0;
+};
+
+#endif // ANALYSISSERVER_H
@@ -0,0 +1,113 @@
+// Arena.cpp
+#include "Arena.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Random legal moves that don't already decide the game; the same pair
+// index always gives the same opening.
+static vector<int> randomOpening(const ArenaConfig& cfg, int pair) {
+    mt19937 rng(cfg.seed * 7919u + pair);
+    for (int attempt = 0; attempt < 100; attempt++) {
+        Scaffold s(cfg.cols, cfg.levels, cfg.N);
+        vector<int> moves;
+        int color = RED;
+        while (static_cast<int>(moves.size()) < cfg.openingPlies
+               && s.state() == PLAYING) {
+            int c = 1 + static_cast<int>(rng() % cfg.cols);
+            if (!s.makeMove(c, color)) continue;
+            moves.push_back(c);
+            color = (color == RED ? BLACK : RED);
+        }
+        if (s.state() == PLAYING) return moves;
+    }
+    return vector<int>();
+}
+
+// Plays one game through Game, which owns the forfeit, record and notify
+// rules; returns the winner's color, VACANT for a draw.  The opening goes
+// in as set moves, so its record has no scores or times.
+static int playGame(const ArenaConfig& cfg, const vector<int>& opening,
+                    Player* red, Player* black) {
+    Game game(cfg.cols, cfg.levels, cfg.N, red, black);
+    game.setRecorder(cfg.recorder);
+    for (int c : opening) game.playOpening(c);
+    Game::Turn t;
+    while (game.nextTurn(t)) {
+        auto start = chrono::steady_clock::now();
+        int col = t.player->chooseMove(*t.position, t.N, t.color);
+        game.playTurn(col, static_cast<int>(chrono::duration_cast<chrono::milliseconds>(
+                               chrono::steady_clock::now() - start).count()));
+    }
+    int winner = VACANT;
+    game.completed(winner);
+    return winner == TIE ? VACANT : winner;
+}
+
+// Score, Elo difference and 95% error bars from the game counts
+static void finishStats(ArenaResult& r) {
+    int n = r.wins + r.draws + r.losses;
+    if (n == 0) return;
+    double p = (r.wins + 0.5 * r.draws) / n;
+    double var = (r.wins   * (1.0 - p) * (1.0 - p)
+                + r.draws  * (0.5 - p) * (0.5 - p)
+                + r.losses * p * p) / n;
+    double se = sqrt(var / n);
+    auto elo = [](double x) {
+        x = min(max(x, 1e-6), 1.0 - 1e-6);
+        return -400.0 * log10(1.0 / x - 1.0);
+    };
+    r.score    = p;
+    r.elo      = elo(p);
+    r.eloError = (elo(p + 1.96 * se) - elo(p - 1.96 * se)) / 2;
+    r.gamesPerSec = r.seconds > 0 ? n / r.seconds : 0;
+}
+
+ArenaResult runArena(const ArenaConfig& cfg, const PlayerFactory& a,
+                     const PlayerFactory& b, const ArenaProgress& progress) {
+    int nThreads = cfg.threads > 0 ? cfg.threads
+                                   : max(1u, thread::hardware_concurrency());
+    auto start = chrono::steady_clock::now();
+    atomic<int> nextGame{0};
+    mutex       lock;
+    ArenaResult result;
+
+    auto work = [&] {
+        unique_ptr<Player> pa = a(), pb = b();
+        pa->setMoveBudget(cfg.moveTimeMs, cfg.moveNodes);
+        pb->setMoveBudget(cfg.moveTimeMs, cfg.moveNodes);
+        for (int g = nextGame++; g < cfg.games; g = nextGame++) {
+            // Even games: A is RED; odd games replay the opening with A BLACK
+            bool aIsRed = (g % 2 == 0);
+            vector<int> opening = randomOpening(cfg, g / 2);
+            int winner = aIsRed ? playGame(cfg, opening, pa.get(), pb.get())
+                                : playGame(cfg, opening, pb.get(), pa.get());
+
+            lock_guard<mutex> guard(lock);
+            if (winner == VACANT)                   result.draws++;
+            else if ((winner == RED) == aIsRed)     result.wins++;
+            else                                    result.losses++;
+            result.seconds = chrono::duration<double>(
+                                 chrono::steady_clock::now() - start).count();
+            finishStats(result);
+            if (progress) progress(result);
+        }
+    };
+
+    vector<thread> pool;
+    for (int i = 1; i < nThreads; i++) pool.emplace_back(work);
+    work();
+    for (thread& t : pool) t.join();
+
+    result.seconds = chrono::duration<double>(
+                         chrono::steady_clock::now() - start).count();
+    finishStats(result);
+    return result;
+}
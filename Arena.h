@@ -0,0 +1,46 @@
+// Arena.h
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "GameCore.h"
+#include <functional>
+#include <memory>
+
+class GameRecordWriter;  // GameRecord.h
+
+//––– Arena: headless bot-vs-bot matches ––––––––––––––––––––––––––––––––––
+// Plays many games between two player types on a pool of threads, with no
+// board display and no waiting for input.  Games come in pairs that share
+// a random opening and swap colors, so neither side profits from the
+// opening or from moving first.  Each worker thread builds its own pair of
+// players from the factories, since players keep per-game search state.
+struct ArenaConfig {
+    int       cols = 7, levels = 6, N = 4;
+    int       games        = 1000;
+    int       threads      = 0;    // 0 = one per hardware thread
+    int       moveTimeMs   = 100;  // per-move budget handed to both players,
+    long long moveNodes    = 0;    //   see Player::setMoveBudget
+    int       openingPlies = 2;    // random moves before the players take over
+    unsigned  seed         = 1;
+    GameRecordWriter* recorder = nullptr;  // every game is appended here if set
+};
+
+struct ArenaResult {
+    int    wins = 0, draws = 0, losses = 0;  // from player A's point of view
+    double score    = 0;   // (wins + draws / 2) / games
+    double elo      = 0;   // A minus B
+    double eloError = 0;   // half-width of the 95% interval
+    double seconds  = 0;
+    double gamesPerSec = 0;
+};
+
+using PlayerFactory = std::function<std::unique_ptr<Player>()>;
+
+// Called after every finished game with the running totals
+using ArenaProgress = std::function<void(const ArenaResult&)>;
+
+ArenaResult runArena(const ArenaConfig& cfg, const PlayerFactory& a,
+                     const PlayerFactory& b,
+                     const ArenaProgress& progress = ArenaProgress());
+
+#endif // ARENA_H
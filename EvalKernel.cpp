@@ -0,0 +1,226 @@
+// EvalKernel.cpp
+#include "EvalKernel.h"
+#include "GameCore.h"
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define EVALKERNEL_X86
+typedef uint64_t U64x2 __attribute__((vector_size(16)));
+typedef uint64_t U64x4 __attribute__((vector_size(32)));
+// Vectors only pass between always-inlined helpers, never across an ABI
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+// The kernel must be inlined into each per-target entry point below
+#if defined(__GNUC__)
+#define KERNEL_INLINE inline __attribute__((always_inline))
+#else
+#define KERNEL_INLINE inline
+#endif
+
+static int countBits(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    int n = 0;
+    for (; x; x &= x - 1) n++;
+    return n;
+#endif
+}
+
+//––– Packed planes ––––––––––––––––––––––––––––––––––––––––––––––––––––––––
+// The Scaffold's words followed by zero padding, so that shifted loads of
+// up to (N-1)*(levels+2) bits plus one vector never run off the end.
+struct PackedBoard {
+    int words = 0, padded = 0;
+    int cols = 0, levels = 0;
+    vector<uint64_t> board;          // every cell of the board
+    vector<uint64_t> own[2];         // RED, BLACK checkers
+    vector<uint64_t> good[2];        // own checkers or reachable empty cells
+};
+
+static PackedBoard& pack(const Scaffold& s, int N) {
+    thread_local PackedBoard pb;
+    const int stride = s.levels() + 1;
+    const int words  = s.maskWords();
+    const int padded = words + ((N - 1) * (stride + 1) >> 6) + 6;
+    if (pb.cols != s.cols() || pb.levels != s.levels() || pb.padded < padded) {
+        pb.cols   = s.cols();
+        pb.levels = s.levels();
+        pb.words  = words;
+        pb.padded = padded;
+        pb.board.assign(padded, 0);
+        for (int c = 0; c < s.cols(); c++)
+            for (int l = 0; l < s.levels(); l++) {
+                int bit = c * stride + l;
+                pb.board[bit >> 6] |= uint64_t(1) << (bit & 63);
+            }
+        for (int i = 0; i < 2; i++) {
+            pb.own[i].assign(padded, 0);
+            pb.good[i].assign(padded, 0);
+        }
+    }
+
+    const uint64_t* red   = s.colorBits(RED);
+    const uint64_t* black = s.colorBits(BLACK);
+    uint64_t prevEmpty = 0;
+    for (int w = 0; w < words; w++) {
+        uint64_t empty = pb.board[w] & ~(red[w] | black[w]);
+        // An empty cell is out of reach when the cell below it is empty too
+        uint64_t unreachable = empty & ((empty << 1) | (prevEmpty >> 63));
+        prevEmpty = empty;
+        pb.own[0][w]  = red[w];
+        pb.own[1][w]  = black[w];
+        pb.good[0][w] = pb.board[w] & ~black[w] & ~unreachable;
+        pb.good[1][w] = pb.board[w] & ~red[w] & ~unreachable;
+    }
+    return pb;
+}
+
+//––– Kernel ––––––––––––––––––––––––––––––––––––––––––––––––––––––––––––––
+// V is uint64_t or a GCC vector of 64-bit lanes; the same code serves all
+// three paths and is inlined into functions compiled for each target.
+template <class V>
+static KERNEL_INLINE V loadAt(const uint64_t* p) {
+    V v;
+    memcpy(&v, p, sizeof v);
+    return v;
+}
+
+// Lanes of the plane shifted right by `s` bits, starting at word `w`
+template <class V>
+static KERNEL_INLINE V shifted(const uint64_t* a, int w, int s) {
+    const uint64_t* p = a + w + (s >> 6);
+    const int r = s & 63;
+    if (r == 0) return loadAt<V>(p);
+    return (loadAt<V>(p) >> r) | (loadAt<V>(p + 1) << (64 - r));
+}
+
+template <class V>
+static KERNEL_INLINE int popcount(const V& v) {
+    int n = 0;
+    for (int i = 0; i < int(sizeof(V) / 8); i++) {
+        uint64_t lane;
+        memcpy(&lane, reinterpret_cast<const char*>(&v) + 8 * i, 8);
+        n += countBits(lane);
+    }
+    return n;
+}
+
+// Adds the windows stepping `d` bits where every cell is good and k >= 1 of
+// them are own checkers to `t`: their number, sum of k and of k*k, and how
+// many have k == N - 1.  With the count held in bits c_j,
+// k = sum_j 2^j c_j and k*k = sum_j 4^j c_j + sum_{j<l} 2^(j+l+1) c_j c_l.
+template <class V>
+static KERNEL_INLINE
+void windowSum(const uint64_t* own, const uint64_t* good, int words, int N, int d,
+               EvalTerms& t) {
+    const int lanes = sizeof(V) / 8;
+    int nb = 1;
+    while ((1 << nb) <= N) nb++;
+
+    for (int w = 0; w < words; w += lanes) {
+        V open = shifted<V>(good, w, 0);
+        V c[5];
+        for (int j = 0; j < nb; j++) c[j] = open ^ open;
+        for (int i = 0; i < N; i++) {
+            if (i > 0) open &= shifted<V>(good, w, i * d);
+            V carry = shifted<V>(own, w, i * d);
+            for (int j = 0; j < nb; j++) {
+                V t = c[j] & carry;
+                c[j] ^= carry;
+                carry = t;
+            }
+        }
+        V any = c[0];
+        for (int j = 1; j < nb; j++) any |= c[j];
+        t.windows += popcount(open & any);
+        for (int j = 0; j < nb; j++) {
+            V oj = open & c[j];
+            int n = popcount(oj);
+            t.checkers += (1LL << j) * n;
+            t.squares  += (1LL << 2 * j) * n;
+            for (int l = j + 1; l < nb; l++)
+                t.squares += (1LL << (j + l + 1)) * popcount(oj & c[l]);
+        }
+        if (N >= 2) {
+            V eq = open;
+            for (int j = 0; j < nb; j++) eq &= ((N - 1) >> j & 1) ? c[j] : ~c[j];
+            t.threats += popcount(eq);
+        }
+    }
+}
+
+template <class V>
+static KERNEL_INLINE
+void bulkTerms(const PackedBoard& pb, int N, EvalTerms out[2]) {
+    const int stride = pb.levels + 1;
+    const int steps[4] = { stride, 1, stride + 1, stride - 1 };
+    for (int i = 0; i < 2; i++) {
+        out[i] = EvalTerms();
+        for (int d : steps)
+            windowSum<V>(pb.own[i].data(), pb.good[i].data(), pb.words, N, d, out[i]);
+    }
+}
+
+static void termsScalar(const PackedBoard& pb, int N, EvalTerms out[2]) {
+    bulkTerms<uint64_t>(pb, N, out);
+}
+
+#ifdef EVALKERNEL_X86
+__attribute__((target("sse2")))
+static void termsSse2(const PackedBoard& pb, int N, EvalTerms out[2]) {
+    bulkTerms<U64x2>(pb, N, out);
+}
+
+__attribute__((target("avx2,popcnt")))
+static void termsAvx2(const PackedBoard& pb, int N, EvalTerms out[2]) {
+    bulkTerms<U64x4>(pb, N, out);
+}
+#endif
+
+//––– EvalKernel –––––––––––––––––––––––––––––––––––––––––––––––––––––––––––
+bool EvalKernel::supported(Isa isa) {
+#ifdef EVALKERNEL_X86
+    if (isa == AVX2) return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+    if (isa == SSE2) return __builtin_cpu_supports("sse2");
+#endif
+    return isa == SCALAR;
+}
+
+EvalKernel::Isa EvalKernel::detect() {
+    static const Isa best = supported(AVX2) ? AVX2 : supported(SSE2) ? SSE2 : SCALAR;
+    return best;
+}
+
+const char* EvalKernel::name(Isa isa) {
+    return isa == AVX2 ? "avx2" : isa == SSE2 ? "sse2" : "scalar";
+}
+
+int EvalKernel::score(const Scaffold& s, int N, int color) {
+    // A board of one word gains nothing from wider vectors
+    return score(s, N, color, s.maskWords() == 1 ? SCALAR : detect());
+}
+
+int EvalKernel::score(const Scaffold& s, int N, int color, Isa isa) {
+    EvalTerms t[2];
+    terms(s, N, t, isa);
+    return EvalParams().score(t[color == RED ? 0 : 1], t[color == RED ? 1 : 0], N);
+}
+
+void EvalKernel::terms(const Scaffold& s, int N, EvalTerms out[2]) {
+    // A board of one word gains nothing from wider vectors
+    terms(s, N, out, s.maskWords() == 1 ? SCALAR : detect());
+}
+
+void EvalKernel::terms(const Scaffold& s, int N, EvalTerms out[2], Isa isa) {
+    const PackedBoard& pb = pack(s, N);
+#ifdef EVALKERNEL_X86
+    if (isa == AVX2) { termsAvx2(pb, N, out); return; }
+    if (isa == SSE2) { termsSse2(pb, N, out); return; }
+#endif
+    termsScalar(pb, N, out);
+}
@@ -0,0 +1,42 @@
+// EvalKernel.h
+#ifndef EVALKERNEL_H
+#define EVALKERNEL_H
+
+#include "EvalParams.h"
+
+class Scaffold;
+
+//––– EvalKernel: SmartPlayer::heuristicScore over whole bitboards –––––––––
+// Scores every window of N cells in all four directions at once from the
+// Scaffold's bit planes instead of walking windows cell by cell.  For each
+// direction the planes are shifted by 0, d, 2d, ... (N-1)d bits: ANDing the
+// shifted "own or reachable empty" plane marks every window a color can
+// still fill, and adding the shifted own-checker planes into bit-sliced
+// counters gives each window's checker count.  The sums EvalParams weighs
+// (EvalTerms: windows, k, k*k and windows one short) then become weighted
+// sums of popcounts over the count bits, bit-identical to the cell-by-cell
+// walk.
+//
+// The planes are processed one 64-bit word at a time (SCALAR), or two or
+// four at a time with SSE2 or AVX2 vectors; the widest the CPU supports is
+// picked at runtime.
+class EvalKernel {
+  public:
+    enum Isa { SCALAR, SSE2, AVX2 };
+    static const int MAX_N = 31;  // longest line the 5-bit counters hold
+
+    // Widest instruction set this CPU runs, detected once
+    static Isa         detect();
+    static bool        supported(Isa isa);
+    static const char* name(Isa isa);
+
+    // heuristicScore(s, N, color) with the default weights, 1 <= N <= MAX_N
+    static int score(const Scaffold& s, int N, int color);
+    static int score(const Scaffold& s, int N, int color, Isa isa);
+
+    // Each color's terms, out[0] RED's and out[1] BLACK's
+    static void terms(const Scaffold& s, int N, EvalTerms out[2]);
+    static void terms(const Scaffold& s, int N, EvalTerms out[2], Isa isa);
+};
+
+#endif // EVALKERNEL_H
@@ -0,0 +1,45 @@
+// EvalParams.cpp
+#include "EvalParams.h"
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+static int* field(EvalParams& p, const string& name) {
+    if (name == "square") return &p.square;
+    if (name == "linear") return &p.linear;
+    if (name == "empty")  return &p.empty;
+    if (name == "threat") return &p.threat;
+    if (name == "tempo")  return &p.tempo;
+    return nullptr;
+}
+
+bool EvalParams::load(const string& path) {
+    ifstream in(path);
+    if (!in) return false;
+    EvalParams p = *this;
+    string line;
+    while (getline(in, line)) {
+        line = line.substr(0, line.find('#'));
+        istringstream words(line);
+        string name, rest;
+        int value;
+        if (!(words >> name)) continue;  // blank or comment
+        int* f = field(p, name);
+        if (!f || !(words >> value) || (words >> rest)) return false;
+        *f = value;
+    }
+    *this = p;
+    return true;
+}
+
+bool EvalParams::save(const string& path) const {
+    ofstream out(path, ios::trunc);
+    out << "# Evaluation weights (EvalParams.h), in 1/" << SCALE << " points\n"
+        << "square " << square << "\n"
+        << "linear " << linear << "\n"
+        << "empty "  << empty  << "\n"
+        << "threat " << threat << "\n"
+        << "tempo "  << tempo  << "\n";
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,65 @@
+// EvalParams.h
+#ifndef EVALPARAMS_H
+#define EVALPARAMS_H
+
+#include <string>
+
+//––– EvalTerms: the sums one color's heuristic score is built from –––––––
+// Over the windows of N cells that hold k >= 1 of the color's checkers,
+// none of the opponent's and only reachable empty cells.
+struct EvalTerms {
+    long long windows  = 0;  // how many there are
+    long long checkers = 0;  // sum of k
+    long long squares  = 0;  // sum of k*k
+    long long threats  = 0;  // those one checker short, k == N - 1
+};
+
+//––– EvalParams: weights of the heuristic evaluation ––––––––––––––––––––––
+// Each such window is worth, to its color,
+//   square*k*k + linear*k + empty*(N - k) + threat*[k == N - 1]
+// and the side to move gets `tempo` on top.  Weights are in 1/SCALE of a
+// point: the score is the sum over both colors' windows (own minus
+// opponent's) divided by SCALE, rounded toward zero.  The defaults give the
+// original k*k + (N - k) per window exactly.
+//
+// tools/tune.cpp fits the weights to self-play results and saves them with
+// save(); SmartPlayer reads the file named by SearchConfig::evalPath.
+struct EvalParams {
+    static const int SCALE = 16;
+
+    int square = 16;
+    int linear = 0;
+    int empty  = 16;
+    int threat = 0;
+    int tempo  = 0;
+
+    // A window with k >= 1 own checkers, in 1/SCALE points
+    int window(int k, int N) const {
+        return square * k * k + linear * k + empty * (N - k) + (k == N - 1 ? threat : 0);
+    }
+
+    // Score for the side to move from both colors' terms
+    int score(const EvalTerms& own, const EvalTerms& opp, int N) const {
+        long long sum = terms(own, N) - terms(opp, N) + tempo;
+        return static_cast<int>(sum / SCALE);
+    }
+
+    long long terms(const EvalTerms& t, int N) const {
+        return square * t.squares + linear * t.checkers
+             + empty * (N * t.windows - t.checkers) + threat * t.threats;
+    }
+
+    bool operator==(const EvalParams& o) const {
+        return square == o.square && linear == o.linear && empty == o.empty
+            && threat == o.threat && tempo == o.tempo;
+    }
+    bool operator!=(const EvalParams& o) const { return !(*this == o); }
+
+    // A text file of "name value" lines, '#' starting a comment.  load()
+    // sets the weights it names and leaves the rest; it fails, changing
+    // nothing, on an unknown name or a malformed line.
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+};
+
+#endif // EVALPARAMS_H
@@ -0,0 +1,136 @@
+// EvalState.h
+#ifndef EVALSTATE_H
+#define EVALSTATE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "EvalParams.h"
+
+//––– EvalState: incrementally maintained heuristic evaluation ––––––––––––
+// Tracks, for every window of N cells in a row (horizontal, vertical and
+// both diagonals), how many RED and BLACK checkers it holds and how many of
+// its empty cells are not yet reachable (more than one above their column's
+// stack).  A window scores EvalParams::window(count, N) for a color when it
+// holds only that color's checkers and every empty cell in it is reachable;
+// the running total of RED's windows minus BLACK's is kept up to date by
+// play()/undo(), which touch only the windows through the changed cells.
+// This is exactly SmartPlayer::heuristicScore, available in O(1).
+class EvalState {
+  public:
+    EvalState() {}
+
+    // Start from an empty cols x levels board with win length N
+    void reset(int cols, int levels, int N, const EvalParams& p = EvalParams()) {
+        if (!m_geo || m_geo->cols != cols || m_geo->levels != levels
+                   || m_geo->N != N)
+            m_geo = std::make_shared<const Geometry>(cols, levels, N);
+        m_height.assign(cols + 1, 0);
+        m_windows.assign(m_geo->numWindows, Counts());
+        for (int w = 0; w < m_geo->numWindows; w++)
+            m_windows[w].unreach = m_geo->initialUnreach[w];
+        m_value.assign(N + 1, 0);
+        for (int k = 1; k <= N; k++) m_value[k] = p.window(k, N);
+        m_tempo = p.tempo;
+        m_score = 0;
+    }
+
+    // Drop a checker of `color` on top of column `col`
+    void play(int col, int color) {
+        const int level = ++m_height[col];
+        const int cell  = m_geo->cellIndex(col, level);
+        forEachWindow(cell, [&](Counts& w) {
+            (color == 1 ? w.red : w.black)++;
+        });
+        if (level < m_geo->levels)  // the cell above is reachable now
+            forEachWindow(cell + 1, [](Counts& w) { w.unreach--; });
+    }
+
+    // Take the top checker (of `color`) back out of column `col`
+    void undo(int col, int color) {
+        const int level = m_height[col]--;
+        const int cell  = m_geo->cellIndex(col, level);
+        if (level < m_geo->levels)
+            forEachWindow(cell + 1, [](Counts& w) { w.unreach++; });
+        forEachWindow(cell, [&](Counts& w) {
+            (color == 1 ? w.red : w.black)--;
+        });
+    }
+
+    // Heuristic score for `color` (1 = RED), the side to move
+    int score(int color) const {
+        return static_cast<int>(((color == 1 ? m_score : -m_score) + m_tempo)
+                                / EvalParams::SCALE);
+    }
+
+  private:
+    struct Counts {
+        uint16_t red = 0, black = 0, unreach = 0;
+    };
+
+    // Window layout for one board size, shared between copies
+    struct Geometry {
+        int cols, levels, N;
+        int numWindows = 0;
+        std::vector<int>      cellStart;      // CSR offsets into cellWindows
+        std::vector<int>      cellWindows;    // window ids through each cell
+        std::vector<uint16_t> initialUnreach; // on the empty board
+
+        int cellIndex(int col, int level) const {
+            return (col - 1) * levels + (level - 1);
+        }
+
+        Geometry(int c, int l, int n) : cols(c), levels(l), N(n) {
+            const int dirs[4][2] = { {1,0}, {0,1}, {1,1}, {1,-1} };
+            std::vector<std::vector<int>> through(cols * levels);
+            for (int col = 1; col <= cols; col++)
+                for (int lv = 1; lv <= levels; lv++)
+                    for (const auto& d : dirs) {
+                        int ec = col + (N - 1) * d[0], el = lv + (N - 1) * d[1];
+                        if (N < 1 || ec > cols || el < 1 || el > levels) continue;
+                        uint16_t unreach = 0;
+                        for (int i = 0; i < N; i++) {
+                            int cl = lv + i * d[1];
+                            through[cellIndex(col + i * d[0], cl)].push_back(numWindows);
+                            if (cl > 1) unreach++;
+                        }
+                        initialUnreach.push_back(unreach);
+                        numWindows++;
+                    }
+            cellStart.push_back(0);
+            for (const auto& t : through) {
+                cellWindows.insert(cellWindows.end(), t.begin(), t.end());
+                cellStart.push_back(static_cast<int>(cellWindows.size()));
+            }
+        }
+    };
+
+    int contribution(const Counts& w) const {
+        if (w.unreach != 0) return 0;
+        if (w.black == 0 && w.red   != 0) return m_value[w.red];
+        if (w.red   == 0 && w.black != 0) return -m_value[w.black];
+        return 0;
+    }
+
+    // Apply `f` to each window through `cell`, keeping m_score in step
+    template <class F>
+    void forEachWindow(int cell, F f) {
+        const int* it  = m_geo->cellWindows.data() + m_geo->cellStart[cell];
+        const int* end = m_geo->cellWindows.data() + m_geo->cellStart[cell + 1];
+        for (; it != end; ++it) {
+            Counts& w = m_windows[*it];
+            m_score -= contribution(w);
+            f(w);
+            m_score += contribution(w);
+        }
+    }
+
+    std::shared_ptr<const Geometry> m_geo;
+    std::vector<int>                m_height;
+    std::vector<Counts>             m_windows;
+    std::vector<int>                m_value;      // window worth by count
+    int                             m_tempo = 0;
+    long long                       m_score = 0;  // RED minus BLACK, in 1/SCALE
+};
+
+#endif // EVALSTATE_H
@@ -0,0 +1,309 @@
+// FixedScaffold.h
+#ifndef FIXEDSCAFFOLD_H
+#define FIXEDSCAFFOLD_H
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include "GameCore.h"
+
+//––– FixedTables: compile-time geometry of one board size –––––––––––––––––
+// Every window of N cells in a row, as a bitmask in the Scaffold's layout
+// and as a CSR list of the windows through each cell, plus the windows'
+// unreachable cells on the empty board, the Zobrist keys of every cell,
+// per-column and whole-board masks and the center-first column order.  All of it is built by constexpr code, so
+// a FixedScaffold carries no setup cost and its loops run over constants.
+template <int Cols, int Levels, int N>
+constexpr int fixedWindowCount() {
+    const int dirs[4][2] = { {1,0}, {0,1}, {1,1}, {1,-1} };
+    int n = 0;
+    for (int col = 1; col <= Cols; col++)
+        for (int lv = 1; lv <= Levels; lv++)
+            for (const auto& d : dirs) {
+                int ec = col + (N - 1) * d[0], el = lv + (N - 1) * d[1];
+                if (ec <= Cols && el >= 1 && el <= Levels) n++;
+            }
+    return n;
+}
+
+template <int Cols, int Levels, int N, class Bits>
+struct FixedTables {
+    static constexpr int kWindows = fixedWindowCount<Cols, Levels, N>();
+    static constexpr int kCells   = Cols * Levels;
+
+    std::array<Bits, kWindows>         mask{};
+    std::array<uint8_t, kWindows>      initialUnreach{};
+    std::array<uint16_t, kCells + 1>   cellStart{};
+    std::array<uint16_t, kWindows * N> cellWindows{};
+    std::array<uint64_t, 2 * kCells>   zobrist{};      // [color - RED][cell]
+    std::array<int, Cols>              centerOrder{};  // 4 3 5 2 6 1 7 for 7
+    std::array<Bits, Cols + 1>         column{};       // cells of each column
+    Bits                               bottom{};       // level 1 of every column
+    Bits                               board{};        // every cell
+
+    static constexpr int cellIndex(int col, int level) { return (col - 1) * Levels + (level - 1); }
+    static constexpr int bitIndex(int col, int level)  { return (col - 1) * (Levels + 1) + (level - 1); }
+
+    static constexpr FixedTables build() {
+        FixedTables t{};
+        const int dirs[4][2] = { {1,0}, {0,1}, {1,1}, {1,-1} };
+        std::array<int, kCells> through{};  // windows through each cell
+        int w = 0;
+        for (int col = 1; col <= Cols; col++)
+            for (int lv = 1; lv <= Levels; lv++)
+                for (const auto& d : dirs) {
+                    int ec = col + (N - 1) * d[0], el = lv + (N - 1) * d[1];
+                    if (ec > Cols || el < 1 || el > Levels) continue;
+                    int unreach = 0;
+                    for (int i = 0; i < N; i++) {
+                        int c = col + i * d[0], l = lv + i * d[1];
+                        t.mask[w] |= Bits(1) << bitIndex(c, l);
+                        through[cellIndex(c, l)]++;
+                        if (l > 1) unreach++;
+                    }
+                    t.initialUnreach[w] = static_cast<uint8_t>(unreach);
+                    w++;
+                }
+
+        for (int cell = 0; cell < kCells; cell++)
+            t.cellStart[cell + 1] = static_cast<uint16_t>(t.cellStart[cell] + through[cell]);
+        for (int col = 1; col <= Cols; col++)
+            for (int lv = 1; lv <= Levels; lv++) {
+                int next = t.cellStart[cellIndex(col, lv)];
+                for (int i = 0; i < kWindows; i++)
+                    if ((t.mask[i] >> bitIndex(col, lv)) & 1)
+                        t.cellWindows[next++] = static_cast<uint16_t>(i);
+                for (int color = RED; color <= BLACK; color++)
+                    t.zobrist[(color - RED) * kCells + cellIndex(col, lv)] =
+                        Scaffold::zobristKey(col, lv, color);
+                t.column[col] |= Bits(1) << bitIndex(col, lv);
+                if (lv == 1) t.bottom |= Bits(1) << bitIndex(col, lv);
+                t.board |= Bits(1) << bitIndex(col, lv);
+            }
+
+        int n = 0;
+        for (int dist = 0; dist <= Cols; dist++)
+            for (int col = 1; col <= Cols; col++) {
+                int d = 2 * col - Cols - 1;
+                if ((d < 0 ? -d : d) == dist) t.centerOrder[n++] = col;
+            }
+        return t;
+    }
+};
+
+//––– FixedScaffold: a board whose size is a compile-time constant –––––––––
+// The search's view of a Cols x Levels board with win length N: the
+// Scaffold's bit layout and Zobrist keys together with EvalState's window
+// counts, so it searches exactly the tree the generic engine searches.
+// With the size fixed, each color is a single 64- or 128-bit integer, the
+// win check tests the constexpr window masks through the new checker, and
+// every loop bound is a constant.
+//
+// makeMove/undoMove keep the board and the win state, evalPlay/evalUndo
+// the evaluation; evalPlay goes after its makeMove and evalUndo before
+// its undoMove.  Moves are assumed legal.
+template <int Cols, int Levels, int N>
+class FixedScaffold {
+  public:
+    static constexpr int kBits  = Cols * (Levels + 1);
+    static constexpr int kCells = Cols * Levels;
+#ifdef __SIZEOF_INT128__
+    static_assert(kBits <= 128, "board does not fit in 128 bits");
+    using Bits = typename std::conditional<(kBits <= 64), uint64_t, unsigned __int128>::type;
+#else
+    static_assert(kBits <= 64, "board does not fit in 64 bits");
+    using Bits = uint64_t;
+#endif
+    using Tables = FixedTables<Cols, Levels, N, Bits>;
+    static constexpr Tables kTables = Tables::build();
+
+    explicit FixedScaffold(const Scaffold& s, const EvalParams& p = EvalParams())
+      : m_tempo(p.tempo) {
+        for (int k = 1; k <= N; k++) m_value[k] = p.window(k, N);
+        for (int w = 0; w < Tables::kWindows; w++)
+            m_windows[w].unreach = kTables.initialUnreach[w];
+        for (int c = 1; c <= Cols; c++)
+            for (int r = 1; r <= Levels && s.checkerAt(c, r) != VACANT; r++) {
+                makeMove(c, s.checkerAt(c, r));
+                evalPlay(c, s.checkerAt(c, r));
+            }
+    }
+
+    static constexpr int cols()   { return Cols; }
+    static constexpr int levels() { return Levels; }
+    static const std::array<int, Cols>& centerOrder() { return kTables.centerOrder; }
+
+    bool      isFull(int col) const { return m_height[col] >= Levels; }
+    int       numberEmpty() const   { return kCells - m_moves; }
+    uint64_t  hash() const          { return m_hash; }
+    uint64_t  mirrorHash() const    { return m_mirror; }
+
+    GameState state() const {
+        if (m_winPly != 0)     return m_winner == RED ? REDWIN : BLACKWIN;
+        if (m_moves == kCells) return TIE;
+        return PLAYING;
+    }
+
+    void makeMove(int col, int color) {
+        const int level = ++m_height[col];
+        const int cell  = Tables::cellIndex(col, level);
+        Bits& p = m_planes[color - RED];
+        p |= Bits(1) << Tables::bitIndex(col, level);
+        m_hash ^= kTables.zobrist[(color - RED) * kCells + cell];
+        m_mirror ^= kTables.zobrist[(color - RED) * kCells + Tables::cellIndex(Cols + 1 - col, level)];
+        m_moves++;
+        if (m_winPly != 0) return;
+        for (int i = kTables.cellStart[cell]; i < kTables.cellStart[cell + 1]; i++) {
+            const Bits m = kTables.mask[kTables.cellWindows[i]];
+            if ((p & m) == m) {
+                m_winPly = m_moves;
+                m_winner = color;
+                return;
+            }
+        }
+    }
+
+    void undoMove(int col) {
+        const int level = m_height[col]--;
+        const int bit   = Tables::bitIndex(col, level);
+        const int color = (m_planes[0] >> bit) & 1 ? RED : BLACK;
+        m_planes[color - RED] &= ~(Bits(1) << bit);
+        m_hash ^= kTables.zobrist[(color - RED) * kCells + Tables::cellIndex(col, level)];
+        m_mirror ^= kTables.zobrist[(color - RED) * kCells + Tables::cellIndex(Cols + 1 - col, level)];
+        if (m_winPly > --m_moves) {
+            m_winPly = 0;
+            m_winner = VACANT;
+        }
+    }
+
+    // Same bookkeeping as EvalState::play/undo
+    void evalPlay(int col, int color) {
+        const int level = m_height[col];
+        const int cell  = Tables::cellIndex(col, level);
+        forEachWindow(cell, [&](Counts& w) { (color == RED ? w.red : w.black)++; });
+        if (level < Levels)
+            forEachWindow(cell + 1, [](Counts& w) { w.unreach--; });
+    }
+
+    void evalUndo(int col, int color) {
+        const int level = m_height[col];
+        const int cell  = Tables::cellIndex(col, level);
+        if (level < Levels)
+            forEachWindow(cell + 1, [](Counts& w) { w.unreach++; });
+        forEachWindow(cell, [&](Counts& w) { (color == RED ? w.red : w.black)--; });
+    }
+
+    int evalScore(int color) const {
+        return ((color == RED ? m_score : -m_score) + m_tempo) / EvalParams::SCALE;
+    }
+
+    // Immediate threats with `color` to move, from whole-board masks: the
+    // first column (center first) where `color` wins at once, the columns
+    // where the opponent would, and the playable cells right under an
+    // opponent's winning cell
+    struct Threats {
+        int  win = 0, block = 0, blocks = 0;
+        Bits unsafe = 0;
+        bool givesAway(int col) const { return (unsafe & kTables.column[col]) != 0; }
+    };
+
+    Threats threats(int color) const {
+        Threats t;
+        const Bits occupied = m_planes[0] | m_planes[1];
+        const Bits playable = (occupied + kTables.bottom) & kTables.board;
+        const Bits wins = winningCells(color, occupied) & playable;
+        if (wins) {
+            for (int c : kTables.centerOrder)
+                if (wins & kTables.column[c]) { t.win = c; return t; }
+        }
+        const Bits oppWins = winningCells(color == RED ? BLACK : RED, occupied);
+        const Bits blocks  = oppWins & playable;
+        if (blocks) {
+            for (int c : kTables.centerOrder)
+                if (blocks & kTables.column[c]) {
+                    if (!t.block) t.block = c;
+                    t.blocks++;
+                }
+        }
+        t.unsafe = (oppWins >> 1) & playable;
+        return t;
+    }
+
+  private:
+    // Empty cells that would complete a line for `color`: for each
+    // direction, a cells' worth of checkers on one side and N-1-a on the
+    // other, found with whole-board shifts
+    Bits winningCells(int color, Bits occupied) const {
+        const Bits p = m_planes[color - RED];
+        const int steps[4] = { 1, Levels + 1, Levels + 2, Levels };
+        auto shl = [](Bits x, int n) { return n < int(8 * sizeof(Bits)) ? Bits(x << n) : Bits(0); };
+        auto shr = [](Bits x, int n) { return n < int(8 * sizeof(Bits)) ? Bits(x >> n) : Bits(0); };
+        Bits r = 0;
+        for (int d : steps) {
+            Bits below[N], above[N];
+            below[0] = above[0] = ~Bits(0);
+            for (int k = 1; k < N; k++) {
+                below[k] = below[k - 1] & shl(p, k * d);
+                above[k] = above[k - 1] & shr(p, k * d);
+            }
+            for (int a = 0; a < N; a++) r |= below[a] & above[N - 1 - a];
+        }
+        return r & kTables.board & ~occupied;
+    }
+
+    struct Counts {
+        uint8_t red = 0, black = 0, unreach = 0;
+    };
+
+    int contribution(const Counts& w) const {
+        if (w.unreach != 0) return 0;
+        if (w.black == 0 && w.red   != 0) return m_value[w.red];
+        if (w.red   == 0 && w.black != 0) return -m_value[w.black];
+        return 0;
+    }
+
+    template <class F>
+    void forEachWindow(int cell, F f) {
+        for (int i = kTables.cellStart[cell]; i < kTables.cellStart[cell + 1]; i++) {
+            Counts& w = m_windows[kTables.cellWindows[i]];
+            m_score -= contribution(w);
+            f(w);
+            m_score += contribution(w);
+        }
+    }
+
+    Bits                                 m_planes[2] = { 0, 0 };
+    std::array<int, Cols + 1>            m_height{};
+    uint64_t                             m_hash   = 0;
+    uint64_t                             m_mirror = 0;  // Scaffold::mirrorHash
+    int                                  m_moves  = 0;
+    int                                  m_winPly = 0;  // move count at first win
+    int                                  m_winner = VACANT;
+    std::array<Counts, Tables::kWindows> m_windows{};
+    std::array<int, N + 1>               m_value{};     // EvalState's window worth
+    int                                  m_tempo  = 0;
+    int                                  m_score  = 0;  // RED minus BLACK, in 1/SCALE
+};
+
+//––– withFixedScaffold: runtime dispatch to the compiled sizes ––––––––––––
+// For the board sizes below, calls f with a null FixedScaffold<C, L, N>*
+// (only its type matters) and returns true.  Any other size returns false
+// and the caller falls back to the generic engine.
+template <class F>
+bool withFixedScaffold(int cols, int levels, int N, F&& f) {
+#define FIXED_SCAFFOLD(C, L, K)                                            \
+    if (cols == C && levels == L && N == K) {                              \
+        f(static_cast<FixedScaffold<C, L, K>*>(nullptr));                  \
+        return true;                                                       \
+    }
+    FIXED_SCAFFOLD(6, 5, 4)
+    FIXED_SCAFFOLD(7, 6, 4)
+    FIXED_SCAFFOLD(8, 7, 4)
+#ifdef __SIZEOF_INT128__
+    FIXED_SCAFFOLD(9, 7, 5)
+#endif
+#undef FIXED_SCAFFOLD
+    return false;
+}
+
+#endif // FIXEDSCAFFOLD_H
@@ -1,8 +1,10 @@
 // Game.cpp
 
 #include "GameCore.h"
+#include "GameRecord.h"
 #include <stack>
 #include <iostream>
+#include <chrono>
 
 using namespace std;
 
@@ -15,18 +17,36 @@ class GameImpl
     bool takeTurn();
     void play();
     int checkerAt(int c, int r) const;
+    void setTimeControl(const TimeControl& tc);
+    void setRecorder(GameRecordWriter* writer);
+    bool nextTurn(Game::Turn& t) const;
+    void playTurn(int col, int elapsedMs);
+    void playOpening(int col);
 private:
-    Scaffold* scaf;
+    void playMove(int col, int color, Player* p);
+    void notifyPlayers(int col, int color);
+    void recordMove(Player* p, int col);
+    void finishRecord();
+    Scaffold scaf;
     Player* redP;
     Player* blackP;
     int connectN; //number of checkers needed to win
     stack<int> turnHistory; // Records turn order, like the move history vector in Scaffold
+    bool timed = false; // players get timeControl, with their own clock in it
+    TimeControl timeControl;
+    int clockMs[3] = {0, 0, 0}; // by color
+    int movesMade[3] = {0, 0, 0};
+    int forfeited = VACANT; // color that ran out of time or played an illegal move, and lost
+    bool flagFell = false;  // forfeited on time
+    GameRecordWriter* recorder = nullptr; // where the record goes, if anywhere
+    GameRecord record;
+    int lastMoveMs = 0; // time the last move took
    
 };
 
 GameImpl::GameImpl(int nColumns, int nLevels, int N, Player* red, Player* black)
+  : scaf(nColumns, nLevels, N)
 {
-    scaf = new Scaffold(nColumns, nLevels);
     redP = red;
     blackP = black;
     connectN = N;
@@ -37,190 +57,152 @@ GameImpl::GameImpl(int nColumns, int nLevels, int N, Player* red, Player* black)
 
 GameImpl::~GameImpl()
 {
-    delete scaf;
+    if (record.active()) // cut short; written with result PLAYING
+        finishRecord();
 }
 
 bool GameImpl::completed(int& winner) const
 {
-    
-
-    for (int i = 1; i <= scaf->levels(); i++) { //Looping through all possible locations
-        for (int j = 1; j <= scaf->cols(); j++) {
-
-
-            //Horizontal Checks
-
-            if (scaf->checkerAt(j, i) == RED) {
-                int horizCheck = 0;
-                for (int k = j; k <= (scaf->cols()); k++) {
-                    if (scaf->checkerAt(k, i) == RED) {
-                        horizCheck++;
-                    }
-                    else {
-                        break;
-                    }
-                }
-                if (horizCheck >= connectN) {
-                    winner = RED;
-                    return true;
-                }
-            }
-            if (scaf->checkerAt(j, i) == BLACK) {
-                int horizCheck = 0;
-                for (int k = j; k <= (scaf->cols()); k++) {
-                    if (scaf->checkerAt(k, i) == BLACK) {
-                        horizCheck++;
-                    }
-                    else {
-                        break;
-                    }
-                }
-                if (horizCheck >= connectN) {
-                    winner = BLACK;
-                    return true;
-                }
-            }
-
-            //Vertical Checks
-            if (scaf->checkerAt(j, i) == RED) {
-                int vertCheck = 0;
-                for (int k = i; k <= (scaf->levels()); k++) {
-                    if (scaf->checkerAt(j, k) == RED) {
-                        vertCheck++;
-                    }
-                    else {
-                        break;
-                    }
-                }
-                if (vertCheck >= connectN) {
-                    winner = RED;
-                    return true;
-                }
-            }
-            if (scaf->checkerAt(j, i) == BLACK) {
-                int vertCheck = 0;
-                for (int k = i; k <= (scaf->levels()); k++) {
-                    if (scaf->checkerAt(j, k) == BLACK) {
-                        vertCheck++;
-                    }
-                    else {
-                        break;
-                    }
-                }
-                if (vertCheck >= connectN) {
-                    winner = BLACK;
-                    return true;
-                }
-            }
-
-            //Up-Right Diagonal Check
-
-            if (scaf->checkerAt(j, i) == RED) {
-                int diagCheck = 0;
-                for (int k = j, l = i; k <= (scaf->cols()) && l <= (scaf->levels()); k++, l++) {
-                    if (scaf->checkerAt(k, l) == RED) {
-                        diagCheck++;
-                    }
-                    else {
-                        break;
-                    }
-                    
-                }
-                if (diagCheck >= connectN) {
-                    winner = RED;
-                    return true;
-                }
-            }
-
-            if (scaf->checkerAt(j, i) == BLACK) {
-                int diagCheck = 0;
-                for (int k = j, l = i; k <= (scaf->cols()) && l <= (scaf->levels()); k++, l++) {
-                    if (scaf->checkerAt(k, l) == BLACK) {
-                        diagCheck++;
-                    }
-                    else {
-                        break;
-                    }
-
-                }
-                if (diagCheck >= connectN) {
-                    winner = BLACK;
-                    return true;
-                }
-            }
-
-            //Down-Right Diagonal Checks
-
-            if (scaf->checkerAt(j, i) == RED) {
-                int diagCheck = 0;
-                for (int k = j, l = i; k <= (scaf->cols()) && l >= 1; k++, l--) {
-                    if (scaf->checkerAt(k, l) == RED) {
-                        diagCheck++;
-                    }
-                    else {
-                        break;
-                    }
-
-                }
-                if (diagCheck >= connectN) {
-                    winner = RED;
-                    return true;
-                }
-            }
-
-            if (scaf->checkerAt(j, i) == BLACK) {
-                int diagCheck = 0;
-                for (int k = j, l = i; k <= (scaf->cols()) && l >= 1; k++, l--) {
-                    if (scaf->checkerAt(k, l) == BLACK) {
-                        diagCheck++;
-                    }
-                    else {
-                        break;
-                    }
-
-                }
-                if (diagCheck >= connectN) {
-                    winner = BLACK;
-                    return true;
-                }
-            }
-        }
+    if (forfeited != VACANT) {
+        winner = (forfeited == RED ? BLACK : RED);
+        return true;
     }
-
-
-    if (this->scaf->numberEmpty() == 0) { //Full scaf, tie game
+    // The Scaffold checks the lines through each dropped checker as it is
+    // played, so the outcome is already known here.
+    switch (scaf.state()) {
+    case REDWIN:
+        winner = RED;
+        return true;
+    case BLACKWIN:
+        winner = BLACK;
+        return true;
+    case TIE: //Full scaf, tie game
         winner = TIE;
         return true;
+    default:
+        return false;
     }
-
-   
-
-    return false;  
 }
 
 bool GameImpl::takeTurn()
+{
+    Game::Turn t;
+    if (!nextTurn(t))
+        return false;
+    cout << t.player->name() << "'s Turn!" << endl;
+    if (t.timed)
+        t.player->setTimeControl(t.budget);
+    auto start = chrono::steady_clock::now();
+    int col = t.player->chooseMove(scaf, connectN, t.color);
+    playTurn(col, static_cast<int>(chrono::duration_cast<chrono::milliseconds>(
+                      chrono::steady_clock::now() - start).count()));
+    if (forfeited == t.color)
+        cout << t.player->name() << (flagFell ? " ran out of time!" : " made an illegal move!") << endl;
+    return true;
+}
+
+// The side to move (turnHistory's top) and, with a time control, the
+// budget for its move with its own clock in it
+bool GameImpl::nextTurn(Game::Turn& t) const
 {
     int a = 0; //arbitrary integer used to check completed
-    if (this->completed(a) == true) {
-        
-        return false; 
+    if (this->completed(a) == true)
+        return false;
+    t.color = turnHistory.top();
+    t.player = (t.color == RED ? redP : blackP);
+    t.N = connectN;
+    t.position = &scaf;
+    t.timed = timed;
+    if (timed) {
+        t.budget = timeControl;
+        t.budget.clockMs = clockMs[t.color];
+        if (t.budget.movesToGo > 0)
+            t.budget.movesToGo -= movesMade[t.color] % t.budget.movesToGo;
     }
-    if (turnHistory.top() == RED) { //Use turnHistory stack to determine who goes next
-        cout << redP->name() << "'s Turn!" << endl;
-        scaf->makeMove(redP->chooseMove(*scaf, connectN, RED), RED);
-        turnHistory.push(BLACK); //Pushing opponents color into the stack to go next
-        
-        return true;
+    return true;
+}
+
+// Charge the mover's clock for the move and play it; running out of time
+// or an illegal move ends the game
+void GameImpl::playTurn(int col, int elapsedMs)
+{
+    int color = turnHistory.top();
+    int a = 0;
+    if (this->completed(a) == true)
+        return;
+    lastMoveMs = elapsedMs;
+    if (timed && timeControl.clockMs > 0) {
+        clockMs[color] -= elapsedMs;
+        if (clockMs[color] < 0) {
+            forfeited = color;
+            flagFell = true;
+            finishRecord();
+            return;
+        }
+        clockMs[color] += timeControl.incrementMs;
+        if (timeControl.movesToGo > 0 && (movesMade[color] + 1) % timeControl.movesToGo == 0)
+            clockMs[color] += timeControl.clockMs;
     }
-    else if (turnHistory.top() == BLACK) {
-        cout << blackP->name() << "'s Turn!" << endl;
-        scaf->makeMove(blackP->chooseMove(*scaf, connectN, BLACK), BLACK);
-        turnHistory.push(RED);
-      
-        return true;
+    movesMade[color]++;
+    playMove(col, color, color == RED ? redP : blackP);
+}
+
+// A set move for the side to move (an opening): played, recorded and
+// announced like a chosen one, but off the clock
+void GameImpl::playOpening(int col)
+{
+    int a = 0;
+    if (this->completed(a) == true)
+        return;
+    playMove(col, turnHistory.top(), nullptr);
+}
+
+// Play `color`'s move, chosen by `p` (nullptr for a set move); an illegal
+// move ends the game
+void GameImpl::playMove(int col, int color, Player* p)
+{
+    if (!scaf.makeMove(col, color)) {
+        forfeited = color;
+        finishRecord();
+        return;
     }
-    
-    return false;  
+    recordMove(p, col);
+    turnHistory.push(color == RED ? BLACK : RED); //Pushing opponents color into the stack to go next
+    notifyPlayers(col, color);
+}
+
+// Add the move just made to the record, with the mover's score and time if
+// it was chosen (p), and write the record out once the game is over
+void GameImpl::recordMove(Player* p, int col)
+{
+    if (!recorder || !record.active())
+        return;
+    if (p) {
+        int score = GameRecord::NO_SCORE;
+        p->lastScore(score);
+        record.addMove(col, score, lastMoveMs);
+    } else
+        record.addMove(col);
+    int winner;
+    if (completed(winner))
+        finishRecord();
+}
+
+void GameImpl::finishRecord()
+{
+    if (!recorder || !record.active())
+        return;
+    record.finish(forfeited != VACANT ? (forfeited == RED ? BLACKWIN : REDWIN) : scaf.state(),
+                  flagFell);
+    recorder->write(record);
+}
+
+// Tell both players about the move just made (once if one plays both sides)
+void GameImpl::notifyPlayers(int col, int color)
+{
+    redP->notifyMove(scaf, connectN, col, color);
+    if (blackP != redP)
+        blackP->notifyMove(scaf, connectN, col, color);
 }
 
 void GameImpl::play()
@@ -228,7 +210,7 @@ void GameImpl::play()
     if (redP->isInteractive() == false && blackP->isInteractive() == false) { //Two bots playing
         int outcome = 69;
         while (this->completed(outcome) == false) {
-            scaf->display();
+            scaf.display();
             cout << "Press enter to continue." << endl; //Stops
             string trash;
             getline(cin, trash); //Just to allow user to observe one move at a time
@@ -236,7 +218,7 @@ void GameImpl::play()
          
 
         }
-        scaf->display();
+        scaf.display();
         if (outcome == RED) {
             cout << this->redP->name() << " (RED) won!" << endl;
             return;
@@ -254,10 +236,10 @@ void GameImpl::play()
     else { // At least one human playing
         int outcome = 69;
         while (this->completed(outcome) == false) {
-            scaf->display(); //Displays before move is made
+            scaf.display(); //Displays before move is made
             this->takeTurn();
         }
-        scaf->display(); //Displays made move
+        scaf.display(); //Displays made move
         if (outcome == RED) {
             cout << this->redP->name() << " (RED) won!" << endl;
             return;
@@ -277,18 +259,31 @@ void GameImpl::play()
 
 int GameImpl::checkerAt(int c, int r) const
 {
-    return scaf->checkerAt(c, r);
+    return scaf.checkerAt(c, r);
 } 
 
+void GameImpl::setTimeControl(const TimeControl& tc)
+{
+    timed = true;
+    timeControl = tc;
+    clockMs[RED] = clockMs[BLACK] = tc.clockMs;
+}
+
+void GameImpl::setRecorder(GameRecordWriter* writer)
+{
+    recorder = writer;
+    if (writer)
+        record.begin(scaf.cols(), scaf.levels(), connectN, redP->name(), blackP->name());
+}
+
 
 Game::Game(int nColumns, int nLevels, int N, Player* red, Player* black)
 {
-    m_impl = new GameImpl(nColumns, nLevels, N, red, black);
+    m_impl.reset(new GameImpl(nColumns, nLevels, N, red, black));
 }
  
 Game::~Game()
 {
-    delete m_impl;
 }
  
 bool Game::completed(int& winner) const
@@ -311,3 +306,27 @@ int Game::checkerAt(int c, int r) const
     return m_impl->checkerAt(c, r);
 }
 
+void Game::setTimeControl(const TimeControl& tc)
+{
+    m_impl->setTimeControl(tc);
+}
+
+void Game::setRecorder(GameRecordWriter* writer)
+{
+    m_impl->setRecorder(writer);
+}
+
+bool Game::nextTurn(Turn& t) const
+{
+    return m_impl->nextTurn(t);
+}
+
+void Game::playTurn(int col, int elapsedMs)
+{
+    m_impl->playTurn(col, elapsedMs);
+}
+
+void Game::playOpening(int col)
+{
+    m_impl->playOpening(col);
+}
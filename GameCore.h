@@ -4,8 +4,25 @@
 
 #include <string>
 #include <vector>
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "TransTable.h"
+#include "EvalState.h"
+#include "Nnue.h"
+#include "OpeningBook.h"
 
 //––– Basic types & enums ––––––––––––––––––––––––––––––––––––––––––––––––––
 enum Color     { VACANT = 0, RED = 1, BLACK = 2 };
@@ -25,13 +42,149 @@ class AlarmClock {
     std::chrono::steady_clock::time_point m_deadline;
 };
 
+//––– TimeControl: how long a player may think about its moves –––––––––––––
+// Either a game clock (time left plus an increment after every move) or a
+// fixed time per move, optionally with node and depth limits.  A Game with
+// a time control hands every player the current one before each move.
+struct TimeControl {
+    int       clockMs     = 0;  // left on the mover's game clock, 0 = no clock
+    int       incrementMs = 0;  // added to the clock after each move
+    int       movesToGo   = 0;  // moves until the clock is refilled, 0 = none
+    int       moveTimeMs  = 0;  // fixed time per move (overrides the clock), 0 = none
+    long long nodes       = 0;  // per-move node or playout limit, 0 = none
+    int       depth       = 0;  // per-move search depth limit, 0 = none
+
+    // Time to aim for (soft) and never to exceed (hard) on the next move,
+    // in ms, with `emptyCells` left on the board (0 if unknown); 0 = none.
+    // The clock is shared out over the mover's remaining moves, counting
+    // at most half the empty cells, and a move may run to four times its
+    // share when the search needs it.
+    void allocate(int emptyCells, double& softMs, double& hardMs) const {
+      softMs = hardMs = 0;
+      if (moveTimeMs > 0) {
+        softMs = hardMs = moveTimeMs;
+        return;
+      }
+      if (clockMs <= 0) return;
+      const double overhead = 20;  // ms lost outside the search per move
+      double left = std::max(1.0, clockMs - overhead);
+      int moves = movesToGo > 0 ? movesToGo : 30;
+      if (emptyCells > 0) moves = std::min(moves, (emptyCells + 1) / 2);
+      moves = std::max(moves, 1);
+      hardMs = std::min(left, (left / moves + incrementMs) * 4);
+      softMs = std::min(hardMs, left / moves + incrementMs * 0.75);
+      if (moves > 1) hardMs = std::min(hardMs, left / 2 + incrementMs);
+      softMs = std::min(softMs, hardMs);
+    }
+};
+
+//––– SearchClock: deadlines for one search ––––––––––––––––––––––––––––––––
+// Reading steady_clock costs about as much as a search node, so the search
+// calls checkHard() only every CHECK_EVERY nodes and otherwise looks at its
+// own atomic stop flag.  The hard deadline ends the search wherever it is;
+// the soft one is consulted between iterations, scaled by how settled the
+// search looks (SmartPlayer::searchRoot).
+class SearchClock {
+  public:
+    static const int CHECK_EVERY = 1024;  // a power of two
+
+    // Deadlines in ms from now; 0 = none
+    void start(double softMs, double hardMs) {
+      m_start   = std::chrono::steady_clock::now();
+      m_softMs  = softMs;
+      m_hardMs  = hardMs;
+      m_expired = false;
+    }
+    double elapsedMs() const {
+      return std::chrono::duration<double, std::milli>(
+                 std::chrono::steady_clock::now() - m_start).count();
+    }
+    bool   limited() const { return m_hardMs > 0; }
+    double softMs()  const { return m_softMs; }
+    double hardMs()  const { return m_hardMs; }
+    // Whether time ran out, soft or hard; sticky until the next start()
+    bool   expired() const { return m_expired.load(std::memory_order_relaxed); }
+
+    bool checkHard() {
+      if (m_hardMs > 0 && elapsedMs() >= m_hardMs) m_expired = true;
+      return expired();
+    }
+    bool pastSoft(double scale) {
+      if (m_softMs > 0 && elapsedMs() >= m_softMs * scale) m_expired = true;
+      return expired();
+    }
+
+  private:
+    std::chrono::steady_clock::time_point m_start;
+    double            m_softMs = 0, m_hardMs = 0;
+    std::atomic<bool> m_expired{false};
+};
+
 //––– Scaffold: holds the board & move history for undo ––––––––––––––––––––
+// The board is kept as bitboards: one bitmask per color plus per-column
+// heights.  Cells are laid out column by column, bit (col-1)*(levels+1) +
+// (level-1), and every column is padded with one always-empty sentinel bit
+// so that lines never run from the top of one column into the next.
+// Boards that fit in 128 bits (e.g. 7x6 fits in one 64-bit word) keep their
+// masks inline; larger boards keep them in the Storage block below.
+//
+// Column heights, the move history and (for large boards) the masks share
+// one allocation, about 2 bits per cell plus 4 bytes per column and per
+// move played; a 1000x1000 board takes 250 KB before its moves.  Copies
+// share the block until one of them changes the board, which then takes a
+// private copy first, so a snapshot that is only read costs nothing and
+// the search threads' copies of the game board cost one memcpy each.
+//
+// When constructed with (or later given) the number of checkers needed to
+// win, the Scaffold checks the lines through every dropped checker and
+// caches the resulting GameState, so state() is O(1).
+//
+// A Zobrist hash of the position is maintained incrementally as well.  The
+// per-cell keys are a fixed function of (col, level, color) rather than a
+// random table, so copies stay cheap and hashes agree across processes.
+// So is the hash of the position's mirror image (column c read as column
+// cols+1-c); a position is symmetric when the two are equal, and a
+// position and its mirror image share canonicalHash().
 class Scaffold {
   public:
-    Scaffold(int columns, int levels)
-      : m_cols(columns), m_levels(levels),
-        m_board(columns+1, std::vector<int>(levels+1, VACANT)), height(columns+1, 0)
-    {}
+    Scaffold(int columns, int levels, int N = 0)
+      : m_cols(columns), m_levels(levels), m_stride(levels + 1),
+        m_words((columns * (levels + 1) + 63) / 64), m_inline(),
+        m_connectN(N), m_winPly(0), m_winner(VACANT), m_hash(0),
+        m_mirrorHash(0), m_numMoves(0), m_store(nullptr)
+    {
+      attach(allocate(std::min(m_cols * m_levels, MIN_MOVES)));
+      std::memset(m_heap, 0, 8 * static_cast<size_t>(heapWords())
+                             + 4 * (static_cast<size_t>(m_cols) + 1));
+    }
+
+    Scaffold(const Scaffold& o)
+      : m_cols(o.m_cols), m_levels(o.m_levels), m_stride(o.m_stride),
+        m_words(o.m_words), m_connectN(o.m_connectN), m_winPly(o.m_winPly),
+        m_winner(o.m_winner), m_hash(o.m_hash), m_mirrorHash(o.m_mirrorHash),
+        m_numMoves(o.m_numMoves), m_store(nullptr)
+    {
+      std::memcpy(m_inline, o.m_inline, sizeof m_inline);
+      o.m_store->refs.fetch_add(1, std::memory_order_relaxed);
+      attach(o.m_store);
+    }
+
+    Scaffold& operator=(const Scaffold& o) {
+      if (this == &o) return *this;
+      o.m_store->refs.fetch_add(1, std::memory_order_relaxed);
+      release();
+      m_cols = o.m_cols;         m_levels = o.m_levels;
+      m_stride = o.m_stride;     m_words = o.m_words;
+      m_connectN = o.m_connectN; m_winPly = o.m_winPly;
+      m_winner = o.m_winner;     m_hash = o.m_hash;
+      m_mirrorHash = o.m_mirrorHash;
+      m_numMoves = o.m_numMoves;
+      std::memcpy(m_inline, o.m_inline, sizeof m_inline);
+      attach(o.m_store);
+      return *this;
+    }
+
+    ~Scaffold() { release(); }
 
     void display() const {
 
@@ -52,19 +205,79 @@ class Scaffold {
     // Attempt to drop into column; returns false if full/invalid
     bool makeMove(int col, int color) {
       if (col < 1 || col > m_cols)      return false;
+      if (color != RED && color != BLACK) return false;
       int h = height[col];
       if (h >= m_levels)                return false;
-      m_board[col][++height[col]] = color;
-      m_moves.push_back(col);
+      if (m_numMoves == m_store->capacity)
+        reallocate(std::min(2 * m_numMoves, m_cols * m_levels));
+      else
+        unshare();
+      int bit = bitIndex(col, ++height[col]);
+      setBit(plane(color), bit);
+      m_hash ^= zobristKey(col, height[col], color);
+      m_mirrorHash ^= zobristKey(m_cols + 1 - col, height[col], color);
+      m_moveList[m_numMoves++] = col;
+      if (m_winPly == 0 && m_connectN > 0 && winsThrough(bit, color)) {
+        m_winPly = m_numMoves;
+        m_winner = color;
+      }
       return true;
     }
 
     // Undo the last move
     void undoMove() {
-      if (m_moves.empty()) return;
-      int col = m_moves.back();
-      m_moves.pop_back();
-      m_board[col][height[col]--] = VACANT;
+      if (m_numMoves == 0) return;
+      unshare();
+      int col = m_moveList[--m_numMoves];
+      int bit = bitIndex(col, height[col]);
+      int color = checkerAt(col, height[col]);
+      m_hash ^= zobristKey(col, height[col], color);
+      m_mirrorHash ^= zobristKey(m_cols + 1 - col, height[col], color);
+      height[col]--;
+      clearBit(plane(RED), bit);
+      clearBit(plane(BLACK), bit);
+      if (m_winPly > m_numMoves) {
+        m_winPly = 0;
+        m_winner = VACANT;
+      }
+    }
+
+    // Change the win length; replays the history so state() stays exact
+    void setConnectN(int N) {
+      if (N == m_connectN) return;
+      std::vector<std::pair<int,int>> replay;  // (col, color), newest first
+      while (m_numMoves > 0) {
+        int col = m_moveList[m_numMoves - 1];
+        replay.push_back({col, checkerAt(col, height[col])});
+        undoMove();
+      }
+      m_connectN = N;
+      for (auto it = replay.rbegin(); it != replay.rend(); ++it)
+        makeMove(it->first, it->second);
+    }
+
+    // Would dropping `color` into `col` complete a line right now?  Checks
+    // the cell on top of the column without touching the board.
+    bool isWinningMove(int col, int color) const {
+      if (col < 1 || col > m_cols) return false;
+      return isWinningCell(col, height[col] + 1, color);
+    }
+
+    // Would a checker of `color` at (col, level) complete a line with the
+    // checkers already on the board?  E.g. level = columnHeight(col) + 2
+    // asks whether playing `col` hands that cell to `color`.
+    bool isWinningCell(int col, int level, int color) const {
+      if (col < 1 || col > m_cols || level < 1 || level > m_levels) return false;
+      return m_connectN > 0 && winsThrough(bitIndex(col, level), color);
+    }
+
+    int columnHeight(int col) const { return height[col]; }
+
+    // Cached outcome of the game so far (first win wins; full board ties)
+    GameState state() const {
+      if (m_winPly != 0)     return m_winner == RED ? REDWIN : BLACKWIN;
+      if (numberEmpty() == 0) return TIE;
+      return PLAYING;
     }
 
     // Inspect a cell
@@ -72,23 +285,165 @@ class Scaffold {
       if (col < 1 || col > m_cols ||
           level < 1 || level > m_levels)
         return VACANT;
-      return m_board[col][level];
+      int bit = bitIndex(col, level);
+      if (testBit(plane(RED), bit))   return RED;
+      if (testBit(plane(BLACK), bit)) return BLACK;
+      return VACANT;
     }
 
+    // Raw color masks in the bit layout described above, maskWords() 64-bit
+    // words per color; for bitboard consumers such as the solver
+    const uint64_t* colorBits(int color) const { return plane(color); }
+    int maskWords()   const { return m_words; }
+
     int cols()        const { return m_cols; }
     int levels()      const { return m_levels; }
+    int connectN()    const { return m_connectN; }
+    uint64_t hash()   const { return m_hash; }
+    uint64_t mirrorHash()    const { return m_mirrorHash; }
+    uint64_t canonicalHash() const { return std::min(m_hash, m_mirrorHash); }
+    bool     symmetric()     const { return m_hash == m_mirrorHash; }
     int numberEmpty() const {
-      return m_cols * m_levels
-             - static_cast<int>(m_moves.size());
+      return m_cols * m_levels - m_numMoves;
+    }
+
+    // splitmix64 finalizer over the cell coordinates and color
+    static constexpr uint64_t zobristKey(int col, int level, int color) {
+      uint64_t z = (uint64_t(uint32_t(col)) << 32 | uint32_t(level) << 2 | uint32_t(color))
+                   + 0x9E3779B97F4A7C15ULL;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      return z ^ (z >> 31);
     }
 
   private:
+    static const int INLINE_WORDS = 2;  // 128 bits per color
+
+    int bitIndex(int col, int level) const {
+      return (col - 1) * m_stride + (level - 1);
+    }
+    const uint64_t* plane(int color) const {
+      return (m_words <= INLINE_WORDS ? m_inline : m_heap)
+             + (color - RED) * m_words;
+    }
+    uint64_t* plane(int color) {
+      return (m_words <= INLINE_WORDS ? m_inline : m_heap)
+             + (color - RED) * m_words;
+    }
+
+    // The shared block: a header, then the masks (large boards only), the
+    // heights of columns 0..cols and room for `capacity` moves, which grows
+    // by doubling
+    struct alignas(16) Storage {
+      std::atomic<int> refs;
+      int              capacity;
+    };
+    static const int MIN_MOVES = 256;
+
+    int heapWords() const { return m_words > INLINE_WORDS ? 2 * m_words : 0; }
+
+    Storage* allocate(int capacity) const {
+      size_t bytes = sizeof(Storage) + 8 * static_cast<size_t>(heapWords())
+                   + 4 * (static_cast<size_t>(m_cols) + 1)
+                   + 4 * static_cast<size_t>(capacity);
+      void* p = std::malloc(bytes);
+      if (!p) throw std::bad_alloc();
+      Storage* st = new (p) Storage;
+      st->refs.store(1, std::memory_order_relaxed);
+      st->capacity = capacity;
+      return st;
+    }
+
+    void attach(Storage* st) {
+      m_store    = st;
+      m_heap     = reinterpret_cast<uint64_t*>(st + 1);
+      height     = reinterpret_cast<int32_t*>(m_heap + heapWords());
+      m_moveList = height + m_cols + 1;
+    }
+
+    static void drop(Storage* st) {
+      if (st && st->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        st->~Storage();
+        std::free(st);
+      }
+    }
+    void release() {
+      drop(m_store);
+      m_store = nullptr;
+    }
+
+    // Copy-on-write: take a private block before changing a shared one
+    void unshare() {
+      if (m_store->refs.load(std::memory_order_acquire) != 1)
+        reallocate(m_store->capacity);
+    }
+
+    // Move to a private block with room for `capacity` moves; the masks and
+    // heights are copied whole, the move list only as far as it is used
+    void reallocate(int capacity) {
+      Storage* old = m_store;
+      const uint64_t* oldHeap = m_heap;
+      const int32_t*  oldMoves = m_moveList;
+      attach(allocate(capacity));
+      std::memcpy(m_heap, oldHeap, 8 * static_cast<size_t>(heapWords())
+                                   + 4 * (static_cast<size_t>(m_cols) + 1));
+      std::memcpy(m_moveList, oldMoves, 4 * static_cast<size_t>(m_numMoves));
+      drop(old);
+    }
+    static bool testBit(const uint64_t* p, int i) {
+      return (p[i >> 6] >> (i & 63)) & 1;
+    }
+    static void setBit(uint64_t* p, int i)   { p[i >> 6] |=  (uint64_t(1) << (i & 63)); }
+    static void clearBit(uint64_t* p, int i) { p[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+
+    // Does the checker at `bit` complete a line of m_connectN?  Only the four
+    // lines through that cell are walked; the sentinel bits stop vertical and
+    // diagonal runs at column edges, the range check stops horizontal ones.
+    bool winsThrough(int bit, int color) const {
+      const uint64_t* p = plane(color);
+      const int limit = m_cols * m_stride;
+      const int steps[4] = { m_stride, 1, m_stride + 1, m_stride - 1 };
+      for (int d : steps) {
+        int run = 1;
+        for (int i = bit + d; run < m_connectN && i < limit && testBit(p, i); i += d)
+          run++;
+        for (int i = bit - d; run < m_connectN && i >= 0 && testBit(p, i); i -= d)
+          run++;
+        if (run >= m_connectN) return true;
+      }
+      return false;
+    }
+
     int                              m_cols, m_levels;
-    std::vector<std::vector<int>>    m_board;
-    std::vector<int>                 height; 
-    std::vector<int>                 m_moves;
+    int                              m_stride;   // bits per column incl. sentinel
+    int                              m_words;    // 64-bit words per color mask
+    uint64_t                         m_inline[2 * INLINE_WORDS];
+    int                              m_connectN; // 0 = no win tracking
+    int                              m_winPly;   // move count at first win, 0 = none
+    int                              m_winner;
+    uint64_t                         m_hash;
+    uint64_t                         m_mirrorHash;  // of the board read right to left
+    int                              m_numMoves;
+    Storage*                         m_store;    // shared, copy-on-write
+    uint64_t*                        m_heap;     // in m_store: RED words, then BLACK words
+    int32_t*                         height;     // in m_store
+    int32_t*                         m_moveList; // in m_store, oldest first
+};
+
+//––– CancelToken: lets whoever asked for a move stop the thinking –––––––––
+// Copies share one flag.  Players poll it where they poll their clock and
+// answer at once with the best move found so far.
+class CancelToken {
+  public:
+    CancelToken() : m_flag(std::make_shared<std::atomic<bool>>(false)) {}
+    void cancel() const    { m_flag->store(true, std::memory_order_relaxed); }
+    bool cancelled() const { return m_flag->load(std::memory_order_relaxed); }
+  private:
+    std::shared_ptr<std::atomic<bool>> m_flag;
 };
 
+class WorkerPool;  // Scheduler.h
+
 //––– Abstract Player –––––––––––––––––––––––––––––––––––––––––––––––––––––
 class Player {
   public:
@@ -96,9 +451,47 @@ class Player {
     virtual ~Player() {}
     virtual int  chooseMove(const Scaffold& s, int N, int color) = 0;
     virtual bool isInteractive() const = 0;
+    // Limit each following move to `ms` milliseconds (<= 0: no time limit)
+    // and/or `nodes` search nodes (0: no limit).  Players without a search
+    // ignore it.
+    virtual void setMoveBudget(int /*ms*/, long long /*nodes*/) {}
+    // Limits for the next move.  By default a fixed share of the clock
+    // goes to setMoveBudget.
+    virtual void setTimeControl(const TimeControl& tc) {
+      double softMs, hardMs;
+      tc.allocate(0, softMs, hardMs);
+      setMoveBudget(static_cast<int>(softMs), tc.nodes);
+    }
+    // Called after every move of the game, by either side, with the board
+    // as it is after `col` was played by `color`.  Players that think on
+    // the opponent's time use it to start and stop.
+    virtual void notifyMove(const Scaffold& /*s*/, int /*N*/, int /*col*/, int /*color*/) {}
+    // The evaluation behind the last chosen move, from the mover's side,
+    // for players that have one
+    virtual bool lastScore(int& /*score*/) const { return false; }
     std::string name() const { return m_name; }
+
+    // chooseMove after handing `budget` (if any) to setTimeControl, giving
+    // up with the best move so far once `cancel` is set.  0 if `cancel` was
+    // set before it began: there is no move, and callers holding a set
+    // token play none (Game::playTurn would take 0 as an illegal move).
+    int chooseMoveCancellable(const Scaffold& s, int N, int color,
+                              const TimeControl* budget, const CancelToken& cancel);
+    // The same on one of `pool`'s threads.  `s` is copied, so the caller's
+    // board may move on; the player must not be asked for another move
+    // before the future is ready.
+    std::future<int> chooseMoveAsync(const Scaffold& s, int N, int color,
+                                     const TimeControl* budget,
+                                     const CancelToken& cancel, WorkerPool& pool);
   protected:
-    std::string m_name;
+    // Set once the move being chosen has been called off
+    bool cancelled() const {
+      const CancelToken* c = m_cancel.load(std::memory_order_acquire);
+      return c && c->cancelled();
+    }
+
+    std::string                      m_name;
+    std::atomic<const CancelToken*>  m_cancel{nullptr};  // of the move being chosen
 };
 
 class HumanPlayer : public Player {
@@ -115,23 +508,234 @@ class BadPlayer : public Player {
     bool isInteractive() const override { return false; }
 };
 
+//––– SearchConfig: SmartPlayer tunables –––––––––––––––––––––––––––––––––
+// maxDepth, moveTimeMs and maxNodes are the player's own time control until
+// a Game (or setMoveBudget) replaces it.
+struct SearchConfig {
+    int hashMB     = 16;    // transposition table size in megabytes
+    int maxDepth   = 0;     // iterative deepening limit, 0 = until time runs out
+    int threads    = 1;     // search threads sharing the table (Lazy SMP)
+    int moveTimeMs = 8750;  // thinking time per move
+    long long maxNodes = 0; // stop after this many nodes, 0 = no limit
+    std::string telemetryPath;  // append one JSON line per search, "" = off
+    std::string bookPath;       // opening book to consult first, "" = none
+    int solverMaxEmpty = 24;    // solve exactly once this few cells are empty, 0 = never
+    std::string solverDbPath;   // persistent exact-score database, "" = none
+    bool fixedEngine = true;    // search with a compile-time sized board when
+                                // one is built for this size (FixedScaffold.h)
+    bool threats = true;        // resolve immediate wins and forced blocks, skip
+                                // moves under an opponent's winning cell
+    bool symmetry = true;       // mirror images share table entries, and
+                                // symmetric positions search one move of
+                                // each mirror pair
+    bool pvs = true;            // principal variation search: moves after the
+                                // first get a zero window, re-searched on a
+                                // fail high; false = plain alpha-beta
+    int aspiration = 25;        // half-width of the window around the last
+                                // iteration's score, 0 = full window
+    EvalParams eval;            // weights of the heuristic evaluation
+    std::string evalPath;       // weights file read over `eval` at startup
+                                // (tools/tune.cpp writes one), "" = none
+    std::string nnuePath;       // network (Nnue.h) that evaluates instead of
+                                // the window heuristic on the board it was
+                                // trained for, "" = none
+    enum Ponder { PONDER_OFF, PONDER_PREDICTED, PONDER_ALL };
+    Ponder ponder = PONDER_OFF; // search on the opponent's time: the position
+                                // after the expected reply, or all replies
+};
+
+//––– SearchStats: per-thread search counters –––––––––––––––––––––––––––––
+// Each search thread owns one and bumps plain counters, so keeping them on
+// costs no locks or shared cache lines.  The time split between evaluation
+// updates and makeMove (which carries the win check) is measured on one
+// node in 64 and scaled up, keeping clock reads off most nodes.
+struct SearchStats {
+    long long nodes            = 0;
+    long long betaCutoffs      = 0;
+    long long firstMoveCutoffs = 0;  // cutoffs caused by the first move tried
+    long long ttProbes         = 0;
+    long long ttHits           = 0;
+    long long evalNs           = 0;  // estimated
+    long long winCheckNs       = 0;  // estimated
+
+    void add(const SearchStats& o) {
+        nodes += o.nodes;               betaCutoffs += o.betaCutoffs;
+        firstMoveCutoffs += o.firstMoveCutoffs;
+        ttProbes += o.ttProbes;         ttHits += o.ttHits;
+        evalNs += o.evalNs;             winCheckNs += o.winCheckNs;
+    }
+};
+
+//––– SearchInfo: what the last chooseMove found ––––––––––––––––––––––––––
+// Counters are summed over all threads.
+struct SearchInfo : SearchStats {
+    int    move     = 0;
+    int    score    = 0;
+    int    depth    = 0;      // deepest completed iteration
+    int    threads  = 0;
+    double ms       = 0;
+    double nps      = 0;
+    bool   timedOut = false;  // the clock, not the depth or node limit, stopped it
+    double softMs   = 0;      // time allotted (TimeControl::allocate), 0 = none
+    double hardMs   = 0;
+    bool   fromBook = false;  // answered by the opening book, no search
+    bool   solved   = false;  // exact score from the solver (game-theoretic)
+    bool   ponderHit = false; // the opponent played the expected reply and the
+                              // search begun on its time was carried on
+};
+
+class Solver;         // defined in Solver.h
+class SolveDatabase;
+
 class SmartPlayer : public Player {
   public:
-    SmartPlayer(const std::string& nm) : Player(nm) {}
+    SmartPlayer(const std::string& nm, const SearchConfig& cfg = SearchConfig());
+    ~SmartPlayer() override;
     int  chooseMove(const Scaffold& s, int N, int color) override;
     bool isInteractive() const override { return false; }
+    void setMoveBudget(int ms, long long nodes) override;
+    void setTimeControl(const TimeControl& tc) override;
+    void notifyMove(const Scaffold& s, int N, int col, int color) override;
+    bool lastScore(int& score) const override;
+    const SearchInfo& lastSearch() const { return m_info; }
+    const EvalParams& evalParams() const { return m_eval; }
+
+    // Full-board reference evaluation for `color` to move, and game-state
+    // check.  The search itself uses the incremental EvalState and the
+    // Scaffold's cached state.  heuristicScore runs the bulk EvalKernel;
+    // heuristicScoreScalar is the original window-by-window walk it is
+    // tested against.
+    static int       heuristicScore(const Scaffold& s, int N, int color,
+                                    const EvalParams& p = EvalParams());
+    static int       heuristicScoreScalar(const Scaffold& s, int N, int color,
+                                          const EvalParams& p = EvalParams());
+    static GameState checkState(const Scaffold& s, int N);
+
+    // Key of a position in the opening book.  A position and its mirror
+    // image share one entry, kept as seen from the one with the smaller
+    // hash; bookMove turns a column into (or back out of) that view.
+    static uint64_t  bookKey(const Scaffold& s, int color);
+    static int       bookMove(const Scaffold& s, int col);
 
   private:
-    int  findBestMove(const Scaffold& s, int N, int color, AlarmClock& ac);
-    int  miniMax(Scaffold& s, int N, int color, int depth,
-                 int alpha, int beta, AlarmClock& ac);
-    int  evaluateState(const Scaffold& s, int N,
-                       int color, int depth, AlarmClock& ac);
-    int  heuristicScore(const Scaffold& s, int N, int color);
-    GameState checkState(const Scaffold& s, int N);
+    // Everything one search thread owns; only the table is shared
+    struct SearchThread {
+        explicit SearchThread(const Scaffold& s) : scaf(s) {}
+        Scaffold                                      scaf;
+        EvalState                                     eval;  // follows scaf
+        NnueState                                     nnue;  // too, with m_nnue
+        std::vector<std::array<int,2>>                killers;  // per ply
+        std::vector<int>                              history;  // [color][col]
+        std::vector<std::vector<std::pair<int,int>>>  moveBuf;  // per ply (key, col)
+        bool                                          hitHorizon = false;
+        SearchStats                                   stats;
+        int completedDepth = 0, bestMove = 0, bestScore = 0;
+    };
+
+    int  findBestMove(const Scaffold& s, int N, int color);
+    int  probeBook(const Scaffold& s, int N, int color);
+    int  probeSolver(const Scaffold& s, int N, int color);
+    int  takePonderResult(const Scaffold& s, int N, int color, double waitMs);
+    void startPondering(const Scaffold& s, int N, int color);
+    void stopPondering();
+    bool stopped() const;
+    void writeTelemetry();
+
+    // The search proper, instantiated (in Players.cpp) for the generic
+    // board over a thread's Scaffold and EvalState and for each FixedScaffold
+    template <class Board>
+    void runThread(SearchThread& t, int idx, int N, int color);
+    template <class Board>
+    void searchRoot(SearchThread& t, Board& b, int idx, int N, int color);
+    template <class Board>
+    void orderMoves(SearchThread& t, const Board& b, int color, int depth,
+                    int ttMove, const typename Board::Threats* th,
+                    std::vector<std::pair<int,int>>& out);
+    template <class Board>
+    int  miniMax(SearchThread& t, Board& b, int N, int color, int depth,
+                 int draft, int alpha, int beta);
+    template <class Board>
+    int  evaluateState(SearchThread& t, Board& b, int color, int depth,
+                       int draft);
+    template <class Board>
+    void play(SearchThread& t, Board& b, int col, int color);
+
+    SearchConfig       m_cfg;
+    EvalParams         m_eval;   // m_cfg.eval, or the file at m_cfg.evalPath
+    std::shared_ptr<const NnueNetwork> m_nnue;  // from m_cfg.nnuePath
+    TimeControl        m_tc;     // from m_cfg until a Game sets one
+    TimeControl        m_limits; // m_tc as the running search started with; the
+                                 // setters may change m_tc while pondering
+    SearchClock        m_clock;  // deadlines of the running search
+    TranspositionTable m_tt;  // shared by all threads, kept across moves
+    int                m_ttCols = 0, m_ttLevels = 0;  // board the table is for
+    std::vector<std::unique_ptr<SearchThread>>  m_threads;
+    std::vector<int>   m_centerOrder;
+    std::atomic<bool>  m_stop{false};
+    SearchInfo         m_info;
+    std::unique_ptr<std::ostream> m_telemetry;  // opened on first use
+    OpeningBook        m_book;                   // mapped on first use
+    bool               m_bookTried = false;
+    std::unique_ptr<Solver>        m_solver;  // for boards it supports
+    std::unique_ptr<SolveDatabase> m_solveDb;
+
+    // Pondering: one background search at a time, over the same threads
+    // and table, joined before the next search starts
+    int                m_color = 0;  // side of the last chooseMove
+    std::thread        m_ponderThread;
+    bool               m_pondering = false;
+    uint64_t           m_ponderHash = 0;
+    int                m_ponderN = 0, m_ponderColor = 0;
+    SearchInfo         m_ponderInfo;
+    bool               m_ponderDone = false;
+    std::mutex         m_ponderMutex;
+    std::condition_variable m_ponderCv;
+};
+
+//––– MCTSPlayer: Monte Carlo tree search (UCT) ––––––––––––––––––––––––––
+struct MCTSConfig {
+    int    threads     = 1;        // tree-parallel workers sharing one tree
+    int    moveTimeMs  = 8750;     // thinking time per move
+    long long maxPlayouts = 0;     // stop after this many playouts, 0 = no limit
+    int    poolNodes   = 1 << 20;  // preallocated tree nodes
+    double exploration = 1.4;      // UCT constant
+    int    virtualLoss = 3;        // visits charged to a path while in flight
+};
+
+struct MCTSInfo {
+    int       move     = 0;
+    long long playouts = 0;
+    int       nodes    = 0;        // tree nodes allocated
+    double    ms       = 0;
+};
+
+struct MCTSNode;  // defined in MCTS.cpp
+
+class MCTSPlayer : public Player {
+  public:
+    MCTSPlayer(const std::string& nm, const MCTSConfig& cfg = MCTSConfig());
+    ~MCTSPlayer() override;
+    int  chooseMove(const Scaffold& s, int N, int color) override;
+    bool isInteractive() const override { return false; }
+    void setMoveBudget(int ms, long long nodes) override;
+    const MCTSInfo& lastSearch() const { return m_info; }
+
+  private:
+    void worker(const Scaffold& root, int N, int color, unsigned seed,
+                AlarmClock& ac);
+    int  expand(MCTSNode& node, const Scaffold& s, int moverOfChildren);
+    int  selectChild(MCTSNode& node);
+    int  playout(Scaffold& s, int color, uint64_t& rng);
+
+    MCTSConfig                  m_cfg;
+    std::unique_ptr<MCTSNode[]> m_pool;
+    std::atomic<int>            m_poolUsed{0};
+    std::atomic<long long>      m_playouts{0};
+    MCTSInfo                    m_info;
 };
 
 class GameImpl;  // defined in Game.cpp
+class GameRecordWriter;  // GameRecord.h
 
 //-- Game facade that uses a private implementation -------------------------
 class Game {
@@ -143,9 +747,37 @@ class Game {
     bool takeTurn();
     void play();
     int  checkerAt(int c, int r) const;
+    // Hand every player this time control (with its own clock, if any)
+    // before each move; a side whose clock runs out loses.  Without one
+    // the players keep their own limits.
+    void setTimeControl(const TimeControl& tc);
+    // Record the game from here on (call before the first move) into
+    // `writer`, which may be shared between games; the record is written
+    // when the game ends, or as unfinished if it is destroyed first
+    void setRecorder(GameRecordWriter* writer);
+
+    // takeTurn in two halves, so that the move can be chosen elsewhere and
+    // later (GameScheduler): who is to move on what, under what budget, and
+    // then the column that player chose and the time it took.  playTurn
+    // charges the clock and plays the move; running out of time or an
+    // illegal move loses.  nextTurn is false once the game is over.
+    struct Turn {
+        Player*         player = nullptr;
+        int             color  = VACANT;
+        int             N      = 0;
+        const Scaffold* position = nullptr;  // valid until playTurn
+        bool            timed  = false;      // budget is set (setTimeControl)
+        TimeControl     budget;
+    };
+    bool nextTurn(Turn& t) const;
+    void playTurn(int col, int elapsedMs);
+    // Play `col` for the side to move as a set move (an opening) rather
+    // than its player's choice: recorded without a score or time, and off
+    // the clock.  Illegal moves lose as in playTurn.
+    void playOpening(int col);
 
   private:
-    GameImpl* m_impl;
+    std::unique_ptr<GameImpl> m_impl;
 };
 
 #endif // GAMECORE_H
@@ -0,0 +1,240 @@
+// GameRecord.cpp
+#include "GameRecord.h"
+#include <cstring>
+
+using namespace std;
+
+static const char kMagic[8] = { 'C', 'N', 'G', 'A', 'M', 'E', 'S', 0 };
+
+static void putVarint(vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+// Decode a varint at `p`, no further than `end`; nullptr if it runs over
+static const uint8_t* getVarint(const uint8_t* p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        uint8_t b = *p++;
+        v |= uint64_t(b & 0x7F) << shift;
+        if (!(b & 0x80)) return p;
+    }
+    return nullptr;
+}
+
+static const uint8_t* skipVarints(const uint8_t* p, const uint8_t* end, int n) {
+    uint64_t v;
+    for (int i = 0; i < n && p; i++) p = getVarint(p, end, v);
+    return p;
+}
+
+static uint64_t zigzag(int v)        { return (uint64_t(int64_t(v)) << 1) ^ uint64_t(int64_t(v) >> 63); }
+static int      unzigzag(uint64_t v) { return static_cast<int>((v >> 1) ^ (~(v & 1) + 1)); }
+
+//––– GameRecord –––––––––––––––––––––––––––––––––––––––––––––––––––––––––––
+void GameRecord::begin(int cols, int levels, int N, const string& red,
+                       const string& black) {
+    m_active = true;
+    m_cols   = cols;
+    m_levels = levels;
+    m_N      = N;
+    m_red    = red;
+    m_black  = black;
+    m_moves.clear();
+    m_scores.clear();
+    m_times.clear();
+}
+
+void GameRecord::addMove(int col, int score, int timeMs) {
+    m_moves.push_back(col);
+    m_scores.push_back(score);
+    m_times.push_back(timeMs);
+}
+
+void GameRecord::finish(int result, bool onTime) {
+    m_active = false;
+    int flags = onTime ? ON_TIME : 0;
+    if (m_cols < 16) flags |= NIBBLES;
+    for (size_t i = 0; i < m_moves.size(); i++) {
+        if (m_scores[i] != NO_SCORE) flags |= SCORES;
+        if (m_times[i] != NO_TIME)   flags |= TIMES;
+    }
+
+    // The body first, then its length in front of it
+    vector<uint8_t>& body = m_bytes;
+    body.clear();
+    body.push_back(static_cast<uint8_t>(flags));
+    body.push_back(static_cast<uint8_t>(result));
+    putVarint(body, m_cols);
+    putVarint(body, m_levels);
+    putVarint(body, m_N);
+    putVarint(body, m_red.size());
+    body.insert(body.end(), m_red.begin(), m_red.end());
+    putVarint(body, m_black.size());
+    body.insert(body.end(), m_black.begin(), m_black.end());
+    putVarint(body, m_moves.size());
+    if (flags & NIBBLES) {
+        for (size_t i = 0; i < m_moves.size(); i += 2) {
+            int hi = i + 1 < m_moves.size() ? m_moves[i + 1] : 0;
+            body.push_back(static_cast<uint8_t>((m_moves[i] & 15) | (hi & 15) << 4));
+        }
+    } else {
+        for (int c : m_moves) putVarint(body, c);
+    }
+    if (flags & SCORES)
+        for (int s : m_scores) putVarint(body, s == NO_SCORE ? 0 : zigzag(s) + 1);
+    if (flags & TIMES)
+        for (int t : m_times) putVarint(body, t == NO_TIME ? 0 : uint64_t(t) + 1);
+
+    vector<uint8_t> length;
+    putVarint(length, body.size());
+    body.insert(body.begin(), length.begin(), length.end());
+}
+
+//––– GameRecordWriter –––––––––––––––––––––––––––––––––––––––––––––––––––––
+bool GameRecordWriter::open(const string& path) {
+    close();
+    GameFileHeader h;
+    {
+        ifstream in(path, ios::binary);
+        if (in && in.read(reinterpret_cast<char*>(&h), sizeof h)) {
+            if (memcmp(h.magic, kMagic, 8) != 0 || h.version != VERSION) return false;
+        } else if (in && in.gcount() != 0) {
+            return false;  // too short to be a game file
+        }
+    }
+    m_out.open(path, ios::binary | ios::app);
+    if (!m_out) return false;
+    if (m_out.tellp() == 0) {
+        memset(&h, 0, sizeof h);
+        memcpy(h.magic, kMagic, 8);
+        h.version = VERSION;
+        m_out.write(reinterpret_cast<const char*>(&h), sizeof h);
+    }
+    m_games = 0;
+    return static_cast<bool>(m_out);
+}
+
+void GameRecordWriter::close() {
+    if (m_out.is_open()) m_out.close();
+}
+
+bool GameRecordWriter::write(const GameRecord& game) {
+    const vector<uint8_t>& b = game.bytes();
+    lock_guard<mutex> lock(m_mutex);
+    if (!m_out) return false;
+    m_out.write(reinterpret_cast<const char*>(b.data()), b.size());
+    m_games++;
+    return static_cast<bool>(m_out);
+}
+
+//––– GameView –––––––––––––––––––––––––––––––––––––––––––––––––––––––––––––
+GameView::Cursor GameView::moves() const {
+    Cursor c;
+    c.m_moves   = m_moves;
+    c.m_scores  = m_scores;
+    c.m_times   = m_times;
+    c.m_end     = m_end;
+    c.m_left    = numMoves;
+    c.m_nibbles = m_nibbles;
+    return c;
+}
+
+bool GameView::Cursor::next(int& col, int& score, int& timeMs) {
+    if (m_left == 0) return false;
+    uint64_t v;
+    if (m_nibbles) {
+        col = (m_moves[m_index >> 1] >> (4 * (m_index & 1))) & 15;
+    } else {
+        m_moves = getVarint(m_moves, m_end, v);
+        col = static_cast<int>(v);
+    }
+    score = GameRecord::NO_SCORE;
+    timeMs = GameRecord::NO_TIME;
+    if (m_scores) {
+        m_scores = getVarint(m_scores, m_end, v);
+        if (v) score = unzigzag(v - 1);
+    }
+    if (m_times) {
+        m_times = getVarint(m_times, m_end, v);
+        if (v) timeMs = static_cast<int>(v - 1);
+    }
+    m_left--;
+    m_index++;
+    return true;
+}
+
+//––– GameRecordReader –––––––––––––––––––––––––––––––––––––––––––––––––––––
+bool GameRecordReader::open(const string& path) {
+    close();
+    if (!m_file.open(path)) return false;
+    const GameFileHeader* h = reinterpret_cast<const GameFileHeader*>(m_file.data());
+    if (m_file.size() < sizeof(GameFileHeader) || memcmp(h->magic, kMagic, 8) != 0
+        || h->version != GameRecordWriter::VERSION) {
+        close();
+        return false;
+    }
+    rewind();
+    return true;
+}
+
+void GameRecordReader::close() {
+    m_file.close();
+    m_pos = 0;
+}
+
+// Parses the fixed fields and finds where the move, score and time columns
+// start, checking that all of them lie inside the record
+bool GameRecordReader::next(GameView& g) {
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(m_file.data());
+    const uint8_t* fileEnd = base + m_file.size();
+    const uint8_t* p = base + m_pos;
+    uint64_t len, v[5];
+    if (p >= fileEnd || !(p = getVarint(p, fileEnd, len))
+        || len > static_cast<uint64_t>(fileEnd - p) || len < 2)
+        return false;
+    const uint8_t* end = p + len;
+
+    int flags = *p++;
+    g.result    = *p++;
+    g.onTime    = (flags & GameRecord::ON_TIME) != 0;
+    g.hasScores = (flags & GameRecord::SCORES) != 0;
+    g.hasTimes  = (flags & GameRecord::TIMES) != 0;
+    g.m_nibbles = (flags & GameRecord::NIBBLES) != 0;
+    for (int i = 0; i < 4; i++) {
+        if (!(p = getVarint(p, end, v[i]))) return false;
+        if (i == 3) {  // red name
+            if (v[3] > static_cast<uint64_t>(end - p)) return false;
+            g.red = string_view(reinterpret_cast<const char*>(p), v[3]);
+            p += v[3];
+        }
+    }
+    if (!(p = getVarint(p, end, v[4])) || v[4] > static_cast<uint64_t>(end - p))
+        return false;
+    g.black = string_view(reinterpret_cast<const char*>(p), v[4]);
+    p += v[4];
+    g.cols   = static_cast<int>(v[0]);
+    g.levels = static_cast<int>(v[1]);
+    g.N      = static_cast<int>(v[2]);
+
+    uint64_t n;
+    if (!(p = getVarint(p, end, n)) || n > static_cast<uint64_t>(end - p) * 2) return false;
+    g.numMoves = static_cast<int>(n);
+    g.m_moves  = p;
+    if (g.m_nibbles)
+        p = (n + 1) / 2 <= static_cast<uint64_t>(end - p) ? p + (n + 1) / 2 : nullptr;
+    else
+        p = skipVarints(p, end, g.numMoves);
+    g.m_scores = g.hasScores ? p : nullptr;
+    if (p && g.hasScores) p = skipVarints(p, end, g.numMoves);
+    g.m_times = g.hasTimes ? p : nullptr;
+    if (p && g.hasTimes) p = skipVarints(p, end, g.numMoves);
+    if (!p) return false;
+    g.m_end = end;
+
+    m_pos = end - base;
+    return true;
+}
@@ -0,0 +1,177 @@
+// GameRecord.h
+#ifndef GAMERECORD_H
+#define GAMERECORD_H
+
+#include <climits>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "GameCore.h"
+#include "MappedFile.h"
+
+//––– Game record file format ––––––––––––––––––––––––––––––––––––––––––––––
+// A 16-byte file header, then games back to back, so files can be appended
+// to and concatenated.  Each game is
+//
+//   varint  bytes in the rest of the record (lets readers skip a game)
+//   byte    flags, GameRecord::SCORES | TIMES | NIBBLES | ON_TIME
+//   byte    result, a GameState (PLAYING for a game cut short)
+//   varint  cols, levels, N
+//   varint  length of the red player's name, then the name; same for black
+//   varint  number of moves
+//   moves   NIBBLES: two columns per byte, low nibble first (cols < 16);
+//           otherwise one varint per column
+//   scores  SCORES: one varint per move, 0 = none, else zigzag(score) + 1
+//   times   TIMES: one varint per move, 0 = none, else milliseconds + 1
+//
+// Varints are little-endian base 128.  A 7x6 game of 30 moves with no
+// scores or times takes about 30 bytes including the names.
+struct GameFileHeader {
+    char     magic[8];    // "CNGAMES\0"
+    uint32_t version;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(GameFileHeader) == 16, "game file header layout");
+
+//––– GameRecord: one game, encoded as it is played ––––––––––––––––––––––––
+// The buffers are kept between games, so a recorder that plays game after
+// game allocates nothing once they have grown.
+class GameRecord {
+  public:
+    enum Flags { SCORES = 1, TIMES = 2, NIBBLES = 4, ON_TIME = 8 };
+    static const int NO_SCORE = INT_MIN;
+    static const int NO_TIME  = -1;
+
+    void begin(int cols, int levels, int N, const std::string& red,
+               const std::string& black);
+    void addMove(int col, int score = NO_SCORE, int timeMs = NO_TIME);
+    // `onTime`: the result came from a clock running out
+    void finish(int result, bool onTime = false);
+
+    bool active() const { return m_active; }
+    int  moves() const  { return static_cast<int>(m_moves.size()); }
+    // The encoded game, valid after finish()
+    const std::vector<uint8_t>& bytes() const { return m_bytes; }
+
+  private:
+    bool                 m_active = false;
+    int                  m_cols = 0, m_levels = 0, m_N = 0;
+    std::string          m_red, m_black;
+    std::vector<int>     m_moves, m_scores, m_times;
+    std::vector<uint8_t> m_bytes;
+};
+
+//––– GameRecordWriter: appends finished games to a file –––––––––––––––––––
+// One writer may take games from many threads; each game goes out whole.
+class GameRecordWriter {
+  public:
+    static const uint32_t VERSION = 1;
+
+    GameRecordWriter() {}
+    ~GameRecordWriter() { close(); }
+    GameRecordWriter(const GameRecordWriter&) = delete;
+    GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+
+    // Append to `path`, starting it with a header if it is new or empty;
+    // false if it cannot be opened or holds something else
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return m_out.is_open(); }
+
+    bool      write(const GameRecord& game);
+    long long games() const { return m_games; }
+
+  private:
+    std::ofstream m_out;
+    std::mutex    m_mutex;
+    long long     m_games = 0;
+};
+
+//––– GameView: one game inside a mapped file ––––––––––––––––––––––––––––––
+// Names and move data point into the mapping; nothing is copied.
+struct GameView {
+    int              cols = 0, levels = 0, N = 0;
+    int              result = PLAYING;
+    bool             onTime = false;
+    bool             hasScores = false, hasTimes = false;
+    std::string_view red, black;
+    int              numMoves = 0;
+
+    // Walks the moves in order with their score and time (NO_SCORE and
+    // NO_TIME where the record has none)
+    class Cursor {
+      public:
+        bool next(int& col, int& score, int& timeMs);
+      private:
+        friend struct GameView;
+        const uint8_t* m_moves = nullptr;
+        const uint8_t* m_scores = nullptr;
+        const uint8_t* m_times = nullptr;
+        const uint8_t* m_end = nullptr;
+        int            m_left = 0, m_index = 0;
+        bool           m_nibbles = false;
+    };
+    Cursor moves() const;
+
+    // Play the game out on `s`, an empty board of this game's size (e.g.
+    // kept from the previous game), calling f(s, col, color, score, timeMs)
+    // after each move; `s` is empty again afterwards.  False if a move is
+    // illegal or `s` does not fit.
+    template <class F>
+    bool forEachPosition(Scaffold& s, F f) const;
+
+  private:
+    friend class GameRecordReader;
+    const uint8_t* m_moves = nullptr;
+    const uint8_t* m_scores = nullptr;
+    const uint8_t* m_times = nullptr;
+    const uint8_t* m_end = nullptr;
+    bool           m_nibbles = false;
+};
+
+//––– GameRecordReader: streams the games of a mapped file –––––––––––––––––
+class GameRecordReader {
+  public:
+    GameRecordReader() {}
+    GameRecordReader(const GameRecordReader&) = delete;
+    GameRecordReader& operator=(const GameRecordReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    // The next game in file order; false at the end or at a damaged or
+    // half-written record
+    bool next(GameView& g);
+    void rewind() { m_pos = sizeof(GameFileHeader); }
+
+    size_t fileBytes() const { return m_file.size(); }
+
+  private:
+    MappedFile m_file;
+    size_t     m_pos = 0;
+};
+
+template <class F>
+bool GameView::forEachPosition(Scaffold& s, F f) const {
+    if (s.cols() != cols || s.levels() != levels || s.numberEmpty() != cols * levels)
+        return false;
+    s.setConnectN(N);
+    Cursor c = moves();
+    int col, score, timeMs, color = RED, played = 0;
+    bool ok = true;
+    while (c.next(col, score, timeMs)) {
+        if (!s.makeMove(col, color)) { ok = false; break; }
+        played++;
+        f(static_cast<const Scaffold&>(s), col, color, score, timeMs);
+        color = (color == RED ? BLACK : RED);
+    }
+    while (played-- > 0) s.undoMove();
+    return ok;
+}
+
+#endif // GAMERECORD_H
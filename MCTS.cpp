@@ -0,0 +1,210 @@
+// MCTS.cpp
+#include "GameCore.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+//––– MCTSNode: one tree node, allocated from MCTSPlayer's pool –––––––––––––
+// Scores are kept in half-points for the player whose move led to the node
+// (2 per win, 1 per draw), so UCT can read them without knowing whose turn
+// it is.  Children of a node occupy one contiguous block of the pool.
+enum { UNEXPANDED, EXPANDING, EXPANDED };
+
+struct MCTSNode {
+    atomic<int> visits{0};
+    atomic<int> score{0};
+    atomic<int> state{UNEXPANDED};
+    int         firstChild  = 0;
+    int         numChildren = 0;
+    int         move  = 0;   // column that led here
+    int         mover = 0;   // color that played it
+
+    void reset(int mv, int who) {
+        visits.store(0, memory_order_relaxed);
+        score.store(0, memory_order_relaxed);
+        state.store(UNEXPANDED, memory_order_relaxed);
+        firstChild = numChildren = 0;
+        move  = mv;
+        mover = who;
+    }
+};
+
+static const int kExpandVisits = 4;  // playouts through a leaf before it grows
+
+static uint64_t nextRandom(uint64_t& x) {  // xorshift64*
+    x ^= x >> 12; x ^= x << 25; x ^= x >> 27;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+//––– MCTSPlayer –––––––––––––––––––––––––––––––––––––––––––––––––––––––––
+MCTSPlayer::MCTSPlayer(const std::string& nm, const MCTSConfig& cfg)
+  : Player(nm), m_cfg(cfg) {}
+
+MCTSPlayer::~MCTSPlayer() {}
+
+void MCTSPlayer::setMoveBudget(int ms, long long nodes) {
+    m_cfg.moveTimeMs  = ms > 0 ? ms : numeric_limits<int>::max();
+    m_cfg.maxPlayouts = nodes;
+}
+
+int MCTSPlayer::chooseMove(const Scaffold& s, int N, int color) {
+    AlarmClock ac(m_cfg.moveTimeMs);  // Time-limited search
+    auto start = chrono::steady_clock::now();
+
+    Scaffold root = s;
+    root.setConnectN(N);
+    if (root.state() != PLAYING) return 0;
+    if (!m_pool) m_pool.reset(new MCTSNode[max(2, m_cfg.poolNodes)]);
+
+    m_pool[0].reset(0, color == RED ? BLACK : RED);
+    m_poolUsed = 1;
+    m_playouts = 0;
+    expand(m_pool[0], root, color);
+
+    // Tree parallelism: all workers walk and grow the same tree
+    vector<thread> helpers;
+    for (int i = 1; i < m_cfg.threads; i++)
+        helpers.emplace_back([&, i] { worker(root, N, color, 0x9E3779B9u * (i + 1), ac); });
+    worker(root, N, color, 0x9E3779B9u, ac);
+    for (thread& h : helpers) h.join();
+
+    // Most visited root move; ties go to the more central column
+    const MCTSNode& r = m_pool[0];
+    int best = 0, bestVisits = -1;
+    for (int i = 0; i < r.numChildren; i++) {
+        const MCTSNode& ch = m_pool[r.firstChild + i];
+        if (ch.visits.load() > bestVisits) {
+            bestVisits = ch.visits.load();
+            best = ch.move;
+        }
+    }
+
+    m_info.move     = best;
+    m_info.playouts = m_playouts.load();
+    m_info.nodes    = min(m_poolUsed.load(), m_cfg.poolNodes);
+    m_info.ms       = chrono::duration<double, milli>(
+                          chrono::steady_clock::now() - start).count();
+    return best;
+}
+
+// One search thread: select with UCT down to a leaf, grow the leaf once it
+// has been visited enough, play a fast rollout, and back up the result.
+// Nodes on the path carry a virtual loss while the rollout is in flight so
+// concurrent workers spread out over different lines.
+void MCTSPlayer::worker(const Scaffold& root, int N, int color, unsigned seed,
+                        AlarmClock& ac) {
+    Scaffold s = root;
+    uint64_t rng = seed | 1;
+    const int vl = m_cfg.virtualLoss;
+    const int rootEmpty = root.numberEmpty();
+    vector<int> path;
+
+    while (!ac.timedOut() && !cancelled()) {
+        if (m_cfg.maxPlayouts > 0 && m_playouts.load(memory_order_relaxed) >= m_cfg.maxPlayouts)
+            break;
+
+        // Selection
+        path.assign(1, 0);
+        MCTSNode* node = &m_pool[0];
+        while (s.state() == PLAYING) {
+            if (node->state.load(memory_order_acquire) != EXPANDED) {
+                // Expansion
+                int expected = UNEXPANDED;
+                if (node->visits.load(memory_order_relaxed) < kExpandVisits
+                    || !node->state.compare_exchange_strong(expected, EXPANDING))
+                    break;
+                expand(*node, s, node->mover == RED ? BLACK : RED);
+            }
+            if (node->numChildren == 0) break;  // pool exhausted
+            int ci = selectChild(*node);
+            node = &m_pool[ci];
+            s.makeMove(node->move, node->mover);
+            path.push_back(ci);
+        }
+
+        // Simulation
+        int winner = playout(s, node->mover == RED ? BLACK : RED, rng);
+        while (s.numberEmpty() < rootEmpty) s.undoMove();
+
+        // Backpropagation, removing the virtual loss added on the way down
+        for (size_t i = 0; i < path.size(); i++) {
+            MCTSNode& n = m_pool[path[i]];
+            n.visits.fetch_add(i == 0 ? 1 : 1 - vl, memory_order_relaxed);
+            int result = winner == n.mover ? 2 : (winner == VACANT ? 1 : 0);
+            if (result) n.score.fetch_add(result, memory_order_relaxed);
+        }
+        m_playouts.fetch_add(1, memory_order_relaxed);
+    }
+}
+
+// Give `node` one child per legal column, center first.  The caller owns
+// the node's EXPANDING state; returns the number of children created.
+int MCTSPlayer::expand(MCTSNode& node, const Scaffold& s, int moverOfChildren) {
+    vector<int> moves;
+    for (int c = 1; c <= s.cols(); c++)
+        if (s.checkerAt(c, s.levels()) == VACANT) moves.push_back(c);
+    stable_sort(moves.begin(), moves.end(), [&](int a, int b) {
+        return abs(2 * a - s.cols() - 1) < abs(2 * b - s.cols() - 1);
+    });
+
+    int k = static_cast<int>(moves.size());
+    int first = 0;
+    if (m_poolUsed.load(memory_order_relaxed) + k <= m_cfg.poolNodes) {
+        first = m_poolUsed.fetch_add(k);
+        if (first + k > m_cfg.poolNodes) k = 0;  // lost the race for the tail
+    } else {
+        k = 0;
+    }
+    for (int i = 0; i < k; i++)
+        m_pool[first + i].reset(moves[i], moverOfChildren);
+    node.firstChild  = first;
+    node.numChildren = k;
+    node.state.store(EXPANDED, memory_order_release);
+    return k;
+}
+
+// UCT choice among the children of an expanded node; unvisited children
+// come first.  Charges the chosen child a virtual loss.
+int MCTSPlayer::selectChild(MCTSNode& node) {
+    double logParent = log(max(1, node.visits.load(memory_order_relaxed)));
+    int best = node.firstChild;
+    double bestValue = -1;
+    for (int i = 0; i < node.numChildren; i++) {
+        const MCTSNode& ch = m_pool[node.firstChild + i];
+        int v = ch.visits.load(memory_order_relaxed);
+        if (v <= 0) { best = node.firstChild + i; break; }
+        double value = ch.score.load(memory_order_relaxed) / (2.0 * v)
+                     + m_cfg.exploration * sqrt(logParent / v);
+        if (value > bestValue) { bestValue = value; best = node.firstChild + i; }
+    }
+    m_pool[best].visits.fetch_add(m_cfg.virtualLoss, memory_order_relaxed);
+    return best;
+}
+
+// Rollout policy: take an immediate win, otherwise block the opponent's
+// immediate win, otherwise play a uniformly random legal column.  Returns
+// the winning color, or VACANT for a draw.
+int MCTSPlayer::playout(Scaffold& s, int color, uint64_t& rng) {
+    thread_local vector<int> legal;
+    legal.resize(s.cols());
+    while (s.state() == PLAYING) {
+        int opp = (color == RED ? BLACK : RED);
+        int n = 0, win = 0, block = 0;
+        for (int c = 1; c <= s.cols(); c++) {
+            if (s.checkerAt(c, s.levels()) != VACANT) continue;
+            legal[n++] = c;
+            if (s.isWinningMove(c, color)) { win = c; break; }
+            if (!block && s.isWinningMove(c, opp)) block = c;
+        }
+        int move = win ? win : block ? block : legal[nextRandom(rng) % n];
+        s.makeMove(move, color);
+        color = opp;
+    }
+    GameState gs = s.state();
+    return gs == REDWIN ? RED : gs == BLACKWIN ? BLACK : VACANT;
+}
@@ -0,0 +1,132 @@
+// MappedFile.h
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32) || defined(_WIN64)
+#define MAPPEDFILE_NO_MMAP
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//––– MappedFile: read-only view of a whole file –––––––––––––––––––––––––––
+// Maps the file with mmap so several processes share one copy in the page
+// cache.  Where mmap is unavailable the file is read into a buffer instead.
+class MappedFile {
+  public:
+    MappedFile() {}
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+#ifdef MAPPEDFILE_NO_MMAP
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) return false;
+        m_buffer.resize(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(m_buffer.data(), m_buffer.size());
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        void* map = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                         MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) return false;
+        m_data = static_cast<const char*>(map);
+        m_size = static_cast<size_t>(st.st_size);
+#endif
+        return true;
+    }
+
+    void close() {
+#ifndef MAPPEDFILE_NO_MMAP
+        if (m_data) munmap(const_cast<char*>(m_data), m_size);
+#endif
+        m_buffer.clear();
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    const char* data() const { return m_data; }
+    size_t      size() const { return m_size; }
+
+    // Replace `path` with `tmp` so readers never see a half-written file
+    static bool replace(const std::string& tmp, const std::string& path) {
+#ifdef MAPPEDFILE_NO_MMAP
+        std::remove(path.c_str());  // rename() does not replace files there
+#endif
+        return std::rename(tmp.c_str(), path.c_str()) == 0;
+    }
+
+    // A temporary name next to `path` that no other writer, in this process
+    // or another, is using at the same time
+    static std::string tempName(const std::string& path) {
+        static std::atomic<unsigned> serial(0);
+#ifdef MAPPEDFILE_NO_MMAP
+        long pid = _getpid();
+#else
+        long pid = getpid();
+#endif
+        return path + ".tmp." + std::to_string(pid) + "." + std::to_string(serial++);
+    }
+
+  private:
+    const char*       m_data = nullptr;
+    size_t            m_size = 0;
+    std::vector<char> m_buffer;
+};
+
+//––– FileLock: one writer at a time for a shared file ––––––––––––––––––––––
+// Holds an exclusive advisory lock (flock) on `path` + ".lock" from
+// construction to destruction, across threads and processes alike.  Where
+// there is no flock it does not lock.
+class FileLock {
+  public:
+    explicit FileLock(const std::string& path) {
+#ifndef MAPPEDFILE_NO_MMAP
+        m_fd = ::open((path + ".lock").c_str(), O_RDWR | O_CREAT, 0666);
+        if (m_fd < 0) return;
+        while (flock(m_fd, LOCK_EX) != 0) {
+            if (errno == EINTR) continue;
+            ::close(m_fd);
+            m_fd = -1;
+            return;
+        }
+#else
+        (void)path;
+#endif
+    }
+    ~FileLock() {
+#ifndef MAPPEDFILE_NO_MMAP
+        if (m_fd >= 0) ::close(m_fd);  // releases the lock
+#endif
+    }
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+  private:
+    int m_fd = -1;
+};
+
+#endif // MAPPEDFILE_H
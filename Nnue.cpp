@@ -0,0 +1,196 @@
+// Nnue.cpp
+#include "Nnue.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NNUE_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+static const char kMagic[8] = { 'C', 'N', 'N', 'N', 'U', 'E', 0, 0 };
+
+static const int H  = NnueNetwork::HIDDEN;
+static const int H2 = NnueNetwork::HIDDEN2;
+
+NnueNetwork::NnueNetwork(int cols, int levels, int N)
+  : w1(2 * cols * levels), m_cols(cols), m_levels(levels), m_N(N) {
+    for (auto& r : w1) r.fill(0);
+}
+
+//––– Layers 2 and 3 ––––––––––––––––––––––––––––––––––––––––––––––––––––––
+// Every path clips the accumulators the same way, forms the same int32 dot
+// products and finishes in finish(), so they agree to the bit.
+static void clip(const int16_t* own, const int16_t* opp, uint8_t* x) {
+    for (int i = 0; i < H; i++) {
+        x[i]     = static_cast<uint8_t>(min<int>(max<int>(own[i], 0), NnueNetwork::ACT_MAX));
+        x[H + i] = static_cast<uint8_t>(min<int>(max<int>(opp[i], 0), NnueNetwork::ACT_MAX));
+    }
+}
+
+static int16_t activate(int32_t sum) {
+    return static_cast<int16_t>(min(max(sum / NnueNetwork::W2_SCALE, 0), NnueNetwork::ACT_MAX));
+}
+
+static int finish(int32_t out) {
+    int points = out / (NnueNetwork::ACT_MAX * NnueNetwork::OUT_SCALE);
+    return min(max(points, -NnueNetwork::MAX_SCORE), NnueNetwork::MAX_SCORE);
+}
+
+static int propagateScalar(const NnueNetwork& n, const uint8_t* x) {
+    int32_t out = n.b3;
+    for (int j = 0; j < H2; j++) {
+        const int8_t* w = &n.w2[j * 2 * H];
+        int32_t sum = n.b2[j];
+        for (int i = 0; i < 2 * H; i++) sum += x[i] * w[i];
+        out += activate(sum) * n.w3[j];
+    }
+    return finish(out);
+}
+
+#ifdef NNUE_X86
+__attribute__((target("sse2")))
+static int32_t hsum(__m128i v) {
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0x4E));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0xB1));
+    return _mm_cvtsi128_si32(v);
+}
+
+// 16-bit lanes: the inputs widened with zeros, the weights with their sign
+__attribute__((target("sse2")))
+static int propagateSse2(const NnueNetwork& n, const uint8_t* x) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i in[2 * H / 8];
+    for (int k = 0; k < 2 * H / 16; k++) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + 16 * k));
+        in[2 * k]     = _mm_unpacklo_epi8(v, zero);
+        in[2 * k + 1] = _mm_unpackhi_epi8(v, zero);
+    }
+    alignas(16) int16_t h[H2];
+    for (int j = 0; j < H2; j++) {
+        const int8_t* w = &n.w2[j * 2 * H];
+        __m128i acc = zero;
+        for (int k = 0; k < 2 * H / 16; k++) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + 16 * k));
+            __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
+            __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(v, v), 8);
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(in[2 * k], lo));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(in[2 * k + 1], hi));
+        }
+        h[j] = activate(n.b2[j] + hsum(acc));
+    }
+    __m128i out = zero;
+    for (int k = 0; k < H2 / 8; k++)
+        out = _mm_add_epi32(out, _mm_madd_epi16(
+                  _mm_load_si128(reinterpret_cast<const __m128i*>(h + 8 * k)),
+                  _mm_loadu_si128(reinterpret_cast<const __m128i*>(&n.w3[8 * k]))));
+    return finish(n.b3 + hsum(out));
+}
+
+// maddubs multiplies the unsigned inputs by the signed weights and adds
+// pairs; with inputs of at most 127 the pairs can't saturate
+__attribute__((target("avx2")))
+static int propagateAvx2(const NnueNetwork& n, const uint8_t* x) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i in[2 * H / 32];
+    for (int k = 0; k < 2 * H / 32; k++)
+        in[k] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + 32 * k));
+    alignas(32) int16_t h[H2];
+    for (int j = 0; j < H2; j++) {
+        const int8_t* w = &n.w2[j * 2 * H];
+        __m256i acc = _mm256_setzero_si256();
+        for (int k = 0; k < 2 * H / 32; k++) {
+            __m256i p = _mm256_maddubs_epi16(
+                in[k], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + 32 * k)));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(p, ones));
+        }
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        h[j] = activate(n.b2[j] + hsum(s));
+    }
+    __m256i out = _mm256_setzero_si256();
+    for (int k = 0; k < H2 / 16; k++)
+        out = _mm256_add_epi32(out, _mm256_madd_epi16(
+                  _mm256_load_si256(reinterpret_cast<const __m256i*>(h + 16 * k)),
+                  _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&n.w3[16 * k]))));
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(out), _mm256_extracti128_si256(out, 1));
+    return finish(n.b3 + hsum(s));
+}
+#endif
+
+int NnueNetwork::propagate(const int16_t* own, const int16_t* opp) const {
+    return propagate(own, opp, EvalKernel::detect());
+}
+
+int NnueNetwork::propagate(const int16_t* own, const int16_t* opp, EvalKernel::Isa isa) const {
+    alignas(32) uint8_t x[2 * H];
+    clip(own, opp, x);
+#ifdef NNUE_X86
+    if (isa == EvalKernel::AVX2) return propagateAvx2(*this, x);
+    if (isa == EvalKernel::SSE2) return propagateSse2(*this, x);
+#endif
+    return propagateScalar(*this, x);
+}
+
+//––– File –––––––––––––––––––––––––––––––––––––––––––––––––––––––––––––––––
+shared_ptr<const NnueNetwork> NnueNetwork::load(const string& path) {
+    MappedFile file;
+    if (!file.open(path) || file.size() < sizeof(NnueHeader)) return nullptr;
+    const NnueHeader* h = reinterpret_cast<const NnueHeader*>(file.data());
+    if (memcmp(h->magic, kMagic, 8) != 0 || h->version != VERSION
+        || h->hidden != H || h->hidden2 != H2 || h->cols == 0 || h->levels == 0)
+        return nullptr;
+
+    shared_ptr<NnueNetwork> net(new NnueNetwork(h->cols, h->levels, h->N));
+    size_t need = sizeof(NnueHeader) + net->w1.size() * sizeof(net->w1[0])
+                + sizeof net->b1 + sizeof net->w2 + sizeof net->b2 + sizeof net->w3
+                + sizeof net->b3;
+    if (file.size() != need) return nullptr;
+    const char* p = file.data() + sizeof(NnueHeader);
+    auto read = [&p](void* dst, size_t n) { memcpy(dst, p, n); p += n; };
+    read(net->w1.data(), net->w1.size() * sizeof(net->w1[0]));
+    read(net->b1.data(), sizeof net->b1);
+    read(net->w2.data(), sizeof net->w2);
+    read(net->b2.data(), sizeof net->b2);
+    read(net->w3.data(), sizeof net->w3);
+    read(&net->b3, sizeof net->b3);
+    return net;
+}
+
+bool NnueNetwork::save(const string& path) const {
+    NnueHeader h;
+    memset(&h, 0, sizeof h);
+    memcpy(h.magic, kMagic, 8);
+    h.version = VERSION;
+    h.cols    = static_cast<uint16_t>(m_cols);
+    h.levels  = static_cast<uint16_t>(m_levels);
+    h.N       = static_cast<uint16_t>(m_N);
+    h.hidden  = H;
+    h.hidden2 = H2;
+
+    // Write to a temporary name of our own and rename, so readers never see
+    // a half file
+    string tmp = MappedFile::tempName(path);
+    {
+        ofstream out(tmp, ios::binary | ios::trunc);
+        out.write(reinterpret_cast<const char*>(&h), sizeof h);
+        out.write(reinterpret_cast<const char*>(w1.data()), w1.size() * sizeof(w1[0]));
+        out.write(reinterpret_cast<const char*>(b1.data()), sizeof b1);
+        out.write(reinterpret_cast<const char*>(w2.data()), sizeof w2);
+        out.write(reinterpret_cast<const char*>(b2.data()), sizeof b2);
+        out.write(reinterpret_cast<const char*>(w3.data()), sizeof w3);
+        out.write(reinterpret_cast<const char*>(&b3), sizeof b3);
+        if (!out) {
+            out.close();
+            remove(tmp.c_str());
+            return false;
+        }
+    }
+    if (MappedFile::replace(tmp, path)) return true;
+    remove(tmp.c_str());
+    return false;
+}
@@ -0,0 +1,135 @@
+// Nnue.h
+#ifndef NNUE_H
+#define NNUE_H
+
+#include "EvalKernel.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+//––– Network file layout ––––––––––––––––––––––––––––––––––––––––––––––––––
+// A fixed 32-byte header followed by NnueNetwork's weights as flat
+// little-endian arrays, in the order they are declared there.
+struct NnueHeader {
+    char     magic[8];    // "CNNNUE\0\0"
+    uint32_t version;
+    uint16_t cols;
+    uint16_t levels;
+    uint16_t N;
+    uint16_t hidden;      // NnueNetwork::HIDDEN
+    uint16_t hidden2;     // NnueNetwork::HIDDEN2
+    uint16_t reserved[5];
+};
+
+static_assert(sizeof(NnueHeader) == 32, "network header layout");
+
+//––– NnueNetwork: a small quantized evaluation network ––––––––––––––––––––
+// Every cell gives two inputs per point of view, "own checker here" and
+// "opponent's checker here".  Layer 1 sums the weights of the inputs that
+// are on into HIDDEN int16 values per side (the accumulators, which
+// NnueState keeps up to date move by move).  Both sides' accumulators,
+// clipped to 0..127 and the side to move's first, feed HIDDEN2 int8 units,
+// clipped again, and an int16 output layer gives the score in points for
+// the side to move.
+//
+// All of it is fixed point: activations are 127 x the real value, layer-2
+// weights W2_SCALE x, output weights OUT_SCALE x; biases are in their
+// layer's product units.  Layers 2 and 3 run as int8 and int16 dot products
+// with AVX2 or SSE2 where the CPU has them (EvalKernel::detect), all paths
+// giving identical results.  tools/nnue.cpp trains a network.
+class NnueNetwork {
+  public:
+    static const uint32_t VERSION  = 1;
+    static const int HIDDEN    = 32;
+    static const int HIDDEN2   = 16;
+    static const int ACT_MAX   = 127;
+    static const int W2_SCALE  = 64;
+    static const int OUT_SCALE = 16;
+    static const int MAX_SCORE = 1 << 14;  // far below the win scores
+
+    NnueNetwork(int cols, int levels, int N);  // all weights zero
+
+    int cols() const   { return m_cols; }
+    int levels() const { return m_levels; }
+    int N() const      { return m_N; }
+    int cells() const  { return m_cols * m_levels; }
+    bool matches(int cols, int levels, int N) const {
+        return m_cols == cols && m_levels == levels && m_N == N;
+    }
+
+    // Row of layer-1 weights for a checker on `cell` ((col-1)*levels +
+    // level-1), own or the opponent's
+    const int16_t* row(int cell, bool own) const {
+        return &w1[(own ? 0 : cells()) + cell][0];
+    }
+
+    // Layers 2 and 3 over the side to move's and the opponent's
+    // accumulators, in points
+    int propagate(const int16_t* own, const int16_t* opp) const;
+    int propagate(const int16_t* own, const int16_t* opp, EvalKernel::Isa isa) const;
+
+    // The network in the file, or nullptr if it is unreadable or not one
+    static std::shared_ptr<const NnueNetwork> load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    std::vector<std::array<int16_t, HIDDEN>> w1;  // [2 * cells], own first
+    std::array<int16_t, HIDDEN>               b1{};
+    std::array<int8_t, HIDDEN2 * 2 * HIDDEN>  w2{};  // one row per unit
+    std::array<int32_t, HIDDEN2>              b2{};
+    std::array<int16_t, HIDDEN2>              w3{};
+    int32_t                                   b3 = 0;
+
+  private:
+    int m_cols, m_levels, m_N;
+};
+
+//––– NnueState: a network's accumulators for one position ––––––––––––––––
+// The counterpart of EvalState: play() and undo() add or take away one
+// checker's rows, so only layers 2 and 3 run per evaluation.
+class NnueState {
+  public:
+    // Start from the empty board
+    void reset(const NnueNetwork* net) {
+        m_net = net;
+        m_height.assign(net->cols() + 1, 0);
+        for (int side = 0; side < 2; side++) m_acc[side] = net->b1;
+    }
+
+    // Drop a checker of `color` (1 = RED) on top of column `col`
+    void play(int col, int color) {
+        const int cell = (col - 1) * m_net->levels() + m_height[col]++;
+        add(m_acc[0], m_net->row(cell, color == 1));
+        add(m_acc[1], m_net->row(cell, color != 1));
+    }
+
+    // Take the top checker (of `color`) back out of column `col`
+    void undo(int col, int color) {
+        const int cell = (col - 1) * m_net->levels() + --m_height[col];
+        sub(m_acc[0], m_net->row(cell, color == 1));
+        sub(m_acc[1], m_net->row(cell, color != 1));
+    }
+
+    // Score for `color`, the side to move
+    int score(int color) const {
+        return color == 1 ? m_net->propagate(m_acc[0].data(), m_acc[1].data())
+                          : m_net->propagate(m_acc[1].data(), m_acc[0].data());
+    }
+
+  private:
+    using Acc = std::array<int16_t, NnueNetwork::HIDDEN>;
+
+    static void add(Acc& a, const int16_t* r) {
+        for (int i = 0; i < NnueNetwork::HIDDEN; i++) a[i] = static_cast<int16_t>(a[i] + r[i]);
+    }
+    static void sub(Acc& a, const int16_t* r) {
+        for (int i = 0; i < NnueNetwork::HIDDEN; i++) a[i] = static_cast<int16_t>(a[i] - r[i]);
+    }
+
+    const NnueNetwork* m_net = nullptr;
+    std::vector<int>   m_height;
+    Acc                m_acc[2];  // seen by RED, by BLACK
+};
+
+#endif // NNUE_H
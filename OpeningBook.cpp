@@ -0,0 +1,85 @@
+// OpeningBook.cpp
+#include "OpeningBook.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+static const char kMagic[8] = { 'C', 'N', 'B', 'O', 'O', 'K', 0, 0 };
+
+bool OpeningBook::open(const string& path) {
+    close();
+    if (!m_file.open(path)) return false;
+
+    const char* base = m_file.data();
+    size_t      len  = m_file.size();
+    const BookHeader* h = reinterpret_cast<const BookHeader*>(base);
+    if (len < sizeof(BookHeader) || memcmp(h->magic, kMagic, 8) != 0
+        || h->version != VERSION
+        || h->count > (len - sizeof(BookHeader)) / sizeof(BookEntry)) {
+        close();
+        return false;
+    }
+    m_header  = h;
+    m_entries = reinterpret_cast<const BookEntry*>(base + sizeof(BookHeader));
+    m_count   = static_cast<size_t>(h->count);
+    return true;
+}
+
+void OpeningBook::close() {
+    m_file.close();
+    m_header = nullptr;
+    m_entries = nullptr;
+    m_count = 0;
+}
+
+bool OpeningBook::matches(int cols, int levels, int N) const {
+    return m_header && m_header->cols == cols && m_header->levels == levels
+           && m_header->N == N;
+}
+
+const BookEntry* OpeningBook::find(uint64_t key) const {
+    const BookEntry* end = m_entries + m_count;
+    const BookEntry* it = lower_bound(m_entries, end, key,
+        [](const BookEntry& e, uint64_t k) { return e.key < k; });
+    return (it != end && it->key == key) ? it : nullptr;
+}
+
+bool OpeningBook::write(const string& path, int cols, int levels, int N,
+                        vector<BookEntry> entries) {
+    sort(entries.begin(), entries.end(), [](const BookEntry& a, const BookEntry& b) {
+        return a.key != b.key ? a.key < b.key : a.depth > b.depth;
+    });
+    entries.erase(unique(entries.begin(), entries.end(),
+                         [](const BookEntry& a, const BookEntry& b) { return a.key == b.key; }),
+                  entries.end());
+
+    BookHeader h;
+    memset(&h, 0, sizeof h);
+    memcpy(h.magic, kMagic, 8);
+    h.version = VERSION;
+    h.cols    = static_cast<uint16_t>(cols);
+    h.levels  = static_cast<uint16_t>(levels);
+    h.N       = static_cast<uint16_t>(N);
+    h.count   = entries.size();
+
+    // Write to a temporary name of our own and rename, so readers never map
+    // a half file and concurrent writers never share one
+    string tmp = MappedFile::tempName(path);
+    {
+        ofstream out(tmp, ios::binary | ios::trunc);
+        out.write(reinterpret_cast<const char*>(&h), sizeof h);
+        out.write(reinterpret_cast<const char*>(entries.data()),
+                  entries.size() * sizeof(BookEntry));
+        if (!out) {
+            out.close();
+            remove(tmp.c_str());
+            return false;
+        }
+    }
+    if (MappedFile::replace(tmp, path)) return true;
+    remove(tmp.c_str());
+    return false;
+}
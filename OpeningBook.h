@@ -0,0 +1,67 @@
+// OpeningBook.h
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+//––– Opening book file format –––––––––––––––––––––––––––––––––––––––––––––
+// A fixed 32-byte header followed by 16-byte entries sorted by key.  All
+// fields are little-endian and naturally aligned, so a mapped file is used
+// as-is: lookups binary-search the mapping with no parsing or copying.
+struct BookHeader {
+    char     magic[8];    // "CNBOOK\0\0"
+    uint32_t version;
+    uint16_t cols, levels, N;
+    uint16_t reserved;
+    uint32_t reserved2;
+    uint64_t count;       // number of entries
+};
+
+struct BookEntry {
+    uint64_t key;         // SmartPlayer::bookKey of the position
+    int32_t  score;       // for the side to move
+    uint16_t move;        // column to play, as SmartPlayer::bookMove gives it
+    uint8_t  depth;       // search depth behind the move
+    uint8_t  reserved;
+};
+
+static_assert(sizeof(BookHeader) == 32, "book header layout");
+static_assert(sizeof(BookEntry) == 16, "book entry layout");
+
+//––– OpeningBook: read-only, memory-mapped book –––––––––––––––––––––––––––
+class OpeningBook {
+  public:
+    static const uint32_t VERSION = 2;  // 2: mirror images share an entry
+
+    OpeningBook() {}
+    ~OpeningBook() { close(); }
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+    // Map the file; false if it is missing or not a valid book
+    bool open(const std::string& path);
+    void close();
+
+    bool   isOpen() const { return m_header != nullptr; }
+    bool   matches(int cols, int levels, int N) const;
+    size_t size() const   { return m_count; }
+
+    // Entry for `key`, or nullptr
+    const BookEntry* find(uint64_t key) const;
+
+    // Sort, de-duplicate (keeping the deepest entry) and write a book
+    static bool write(const std::string& path, int cols, int levels, int N,
+                      std::vector<BookEntry> entries);
+
+  private:
+    MappedFile        m_file;
+    const BookHeader* m_header  = nullptr;
+    const BookEntry*  m_entries = nullptr;
+    size_t            m_count   = 0;
+};
+
+#endif // OPENINGBOOK_H
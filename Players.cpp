@@ -1,12 +1,139 @@
 // Players.cpp
 #include "GameCore.h"
+#include "Solver.h"
+#include "FixedScaffold.h"
+#include "EvalKernel.h"
+#include "Scheduler.h"
 #include <iostream>
 #include <limits>
 #include <algorithm>
 #include <climits>
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <type_traits>
 
 using namespace std;
 static const int INF = numeric_limits<int>::max() / 2;
+static const int WIN = 100000;
+static const int SCORE_DROP = 20;  // heuristic loss that buys a search more time
+
+// Win scores are "WIN - plies from the root"; the table stores them relative
+// to the node instead so an entry stays valid wherever it is probed from.
+static int scoreToTT(int score, int depth) {
+    if (score >  WIN / 2) return score + depth;
+    if (score < -WIN / 2) return score - depth;
+    return score;
+}
+
+static int scoreFromTT(int score, int depth) {
+    if (score >  WIN / 2) return score - depth;
+    if (score < -WIN / 2) return score + depth;
+    return score;
+}
+
+// Position key for the side to move and win length
+static uint64_t ttKey(uint64_t hash, int N, int color) {
+    return hash ^ Scaffold::zobristKey(0, N, 3)
+                ^ (color == BLACK ? Scaffold::zobristKey(0, 0, BLACK) : 0);
+}
+
+// With symmetry on, a position and its mirror image share the entry of the
+// one with the smaller hash; `flip` is set when that is the mirror image,
+// whose moves are column cols+1-c of ours
+static uint64_t ttKey(uint64_t hash, uint64_t mirror, bool symmetry, int N, int color,
+                      bool& flip) {
+    flip = symmetry && mirror < hash;
+    return ttKey(flip ? mirror : hash, N, color);
+}
+
+// The generic engine's board: a search thread's runtime-sized Scaffold and
+// EvalState.  FixedScaffold offers the same interface for the sizes it is
+// compiled for.
+struct DynamicBoard {
+    Scaffold&          scaf;
+    EvalState&         eval;
+    const vector<int>& order;  // center first
+
+    int       cols() const                 { return scaf.cols(); }
+    bool      isFull(int col) const        { return scaf.checkerAt(col, scaf.levels()) != VACANT; }
+    int       numberEmpty() const          { return scaf.numberEmpty(); }
+    uint64_t  hash() const                 { return scaf.hash(); }
+    uint64_t  mirrorHash() const           { return scaf.mirrorHash(); }
+    GameState state() const                { return scaf.state(); }
+    const vector<int>& centerOrder() const { return order; }
+    void      makeMove(int col, int color) { scaf.makeMove(col, color); }
+    void      undoMove(int)                { scaf.undoMove(); }
+    void      evalPlay(int col, int color) { eval.play(col, color); }
+    void      evalUndo(int col, int color) { eval.undo(col, color); }
+    int       evalScore(int color) const   { return eval.score(color); }
+
+    // Immediate threats with `color` to move, checked column by column (see
+    // FixedScaffold::threats)
+    struct Threats {
+        int win = 0, block = 0, blocks = 0;
+        const Scaffold* scaf = nullptr;
+        int opp = 0;
+        bool givesAway(int col) const {
+            return scaf->isWinningCell(col, scaf->columnHeight(col) + 2, opp);
+        }
+    };
+
+    Threats threats(int color) const {
+        Threats t;
+        t.scaf = &scaf;
+        t.opp  = (color == RED ? BLACK : RED);
+        for (int c : order) {
+            if (isFull(c)) continue;
+            if (scaf.isWinningMove(c, color)) { t.win = c; return t; }
+            if (scaf.isWinningMove(c, t.opp)) {
+                if (!t.block) t.block = c;
+                t.blocks++;
+            }
+        }
+        return t;
+    }
+};
+
+// Either board with a network's accumulators standing in for its window
+// evaluation, which is then left alone
+template <class Base>
+struct NnueBoard : Base {
+    using Plain = Base;
+
+    NnueBoard(const Base& b, NnueState& n) : Base(b), nnue(n) {}
+    void evalPlay(int col, int color) { nnue.play(col, color); }
+    void evalUndo(int col, int color) { nnue.undo(col, color); }
+    int  evalScore(int color) const   { return nnue.score(color); }
+
+    NnueState& nnue;
+};
+
+template <class Board> struct IsNnueBoard : false_type {};
+template <class Base>  struct IsNnueBoard<NnueBoard<Base>> : true_type {};
+
+//––– Player –––––––––––––––––––––––––––––––––––––––––––––––––––––––––––––
+int Player::chooseMoveCancellable(const Scaffold& s, int N, int color,
+                                  const TimeControl* budget, const CancelToken& cancel) {
+    if (cancel.cancelled()) return 0;
+    if (budget) setTimeControl(*budget);
+    m_cancel = &cancel;
+    int col = chooseMove(s, N, color);
+    m_cancel = nullptr;
+    return col;
+}
+
+future<int> Player::chooseMoveAsync(const Scaffold& s, int N, int color,
+                                    const TimeControl* budget,
+                                    const CancelToken& cancel, WorkerPool& pool) {
+    auto done = make_shared<promise<int>>();
+    bool timed = budget != nullptr;
+    TimeControl tc = timed ? *budget : TimeControl();
+    pool.post([this, s, N, color, timed, tc, cancel, done] {
+        done->set_value(chooseMoveCancellable(s, N, color, timed ? &tc : nullptr, cancel));
+    });
+    return done->get_future();
+}
 
 //––– HumanPlayer –––––––––––––––––––––––––––––––––––––––––––––––––––––––––
 int HumanPlayer::chooseMove(const Scaffold& s, int N, int color) {
@@ -36,81 +163,650 @@ int BadPlayer::chooseMove(const Scaffold& s, int N, int color) {
 }
 
 //––– SmartPlayer ––––––––––––––––––––––––––––––––––––––––––––––––––––––––
+SmartPlayer::SmartPlayer(const string& nm, const SearchConfig& cfg)
+  : Player(nm), m_cfg(cfg), m_eval(cfg.eval), m_tt(cfg.hashMB) {
+    // An unreadable weights file leaves the configured weights
+    if (!cfg.evalPath.empty()) m_eval.load(cfg.evalPath);
+    if (!cfg.nnuePath.empty()) m_nnue = NnueNetwork::load(cfg.nnuePath);
+    m_tc.moveTimeMs = cfg.moveTimeMs;
+    m_tc.nodes      = cfg.maxNodes;
+    m_tc.depth      = cfg.maxDepth;
+}
+
+SmartPlayer::~SmartPlayer() { stopPondering(); }
+
 int SmartPlayer::chooseMove(const Scaffold& s, int N, int color) {
-    AlarmClock ac(8750);  // Time-limited search
-    return findBestMove(s, N, color, ac);
+    m_color = color;
+    double softMs, hardMs;
+    m_tc.allocate(s.numberEmpty(), softMs, hardMs);
+    int move = probeBook(s, N, color);
+    if (move == 0) move = takePonderResult(s, N, color, softMs);
+    stopPondering();
+    if (move) return move;
+
+    m_clock.start(softMs, hardMs);
+    move = probeSolver(s, N, color);
+    if (move) return move;
+    // Keys cover the checkers, not the board's size, so a table filled on
+    // another board would answer for the wrong positions
+    if (s.cols() != m_ttCols || s.levels() != m_ttLevels) {
+        m_tt.clear();
+        m_ttCols   = s.cols();
+        m_ttLevels = s.levels();
+    }
+    m_tt.newSearch();
+    m_stop = false;
+    m_limits = m_tc;
+    return findBestMove(s, N, color);
+}
+
+uint64_t SmartPlayer::bookKey(const Scaffold& s, int color) {
+    return s.canonicalHash() ^ (color == BLACK ? Scaffold::zobristKey(0, 0, BLACK) : 0);
+}
+
+int SmartPlayer::bookMove(const Scaffold& s, int col) {
+    return s.mirrorHash() < s.hash() ? s.cols() + 1 - col : col;
+}
+
+// Book move for this position, or 0 to search
+int SmartPlayer::probeBook(const Scaffold& s, int N, int color) {
+    if (m_cfg.bookPath.empty()) return 0;
+    if (!m_bookTried) {
+        m_book.open(m_cfg.bookPath);
+        m_bookTried = true;
+    }
+    if (!m_book.matches(s.cols(), s.levels(), N)) return 0;
+
+    const BookEntry* e = m_book.find(bookKey(s, color));
+    if (!e || e->move < 1 || e->move > s.cols()) return 0;
+    int move = bookMove(s, e->move);
+    if (s.checkerAt(move, s.levels()) != VACANT) return 0;
+    m_info = SearchInfo();
+    m_info.move     = move;
+    m_info.score    = e->score;
+    m_info.depth    = e->depth;
+    m_info.fromBook = true;
+    if (!m_cfg.telemetryPath.empty()) writeTelemetry();
+    return move;
+}
+
+// Perfect move from the solver, or 0 to search.  Positions already in the
+// solve database are answered at once; otherwise the solver is tried once
+// few enough cells are left, with half the move time.
+int SmartPlayer::probeSolver(const Scaffold& s, int N, int color) {
+    if (m_cfg.solverMaxEmpty <= 0 || !Solver::supports(s.cols(), s.levels(), N))
+        return 0;
+    if (!m_solver || !m_solver->matches(s.cols(), s.levels(), N)) {
+        m_solver.reset(new Solver(s.cols(), s.levels(), N));
+        m_solveDb.reset();
+        if (!m_cfg.solverDbPath.empty()) {
+            m_solveDb.reset(new SolveDatabase);
+            if (m_solveDb->open(m_cfg.solverDbPath, s.cols(), s.levels(), N))
+                m_solver->setDatabase(m_solveDb.get());
+            else
+                m_solveDb.reset();
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    long long nodes = m_solver->nodes();
+    int score = 0;
+    int move = m_solver->lookupMove(s, color, score);
+    if (move == 0 && s.numberEmpty() <= m_cfg.solverMaxEmpty) {
+        AlarmClock ac(m_clock.limited() ? max(1, static_cast<int>(m_clock.softMs() / 2))
+                                        : numeric_limits<int>::max());
+        move = m_solver->bestMove(s, color, score, &ac,
+                                  m_cancel.load(memory_order_acquire));
+    }
+    if (move == 0) return 0;
+
+    m_info = SearchInfo();
+    m_info.move    = move;
+    m_info.score   = score;
+    m_info.depth   = s.numberEmpty();
+    m_info.threads = 1;
+    m_info.nodes   = m_solver->nodes() - nodes;
+    m_info.ms      = chrono::duration<double, milli>(
+                         chrono::steady_clock::now() - start).count();
+    m_info.nps     = m_info.ms > 0 ? m_info.nodes * 1000.0 / m_info.ms : 0;
+    m_info.solved  = true;
+    if (!m_cfg.telemetryPath.empty()) writeTelemetry();
+    return move;
+}
+
+//––– Pondering –––––––––––––––––––––––––––––––––––––––––––––––––––––––––––
+// After its own move the player keeps searching on the opponent's time, in
+// one background thread that drives the usual search threads, with no clock
+// and sharing the table.  PONDER_PREDICTED searches the position after the
+// table's best reply; if the opponent plays it, chooseMove lets that search
+// run on for the move's time and takes its answer, so the deeper iterations
+// already done count.  PONDER_ALL searches the opponent's own position,
+// which leaves every reply's subtree in the table.  Any other move stops
+// the background search at once; the table keeps what it found.
+void SmartPlayer::notifyMove(const Scaffold& s, int N, int /*col*/, int color) {
+    if (m_cfg.ponder == SearchConfig::PONDER_OFF) return;
+    if (color != m_color) {
+        if (!(s.hash() == m_ponderHash && N == m_ponderN)) stopPondering();
+        return;
+    }
+    stopPondering();
+    if (s.state() == PLAYING) startPondering(s, N, color == RED ? BLACK : RED);
+}
+
+// `color` is the opponent, to move in `s`
+void SmartPlayer::startPondering(const Scaffold& s, int N, int color) {
+    Scaffold pos = s;
+    pos.setConnectN(N);
+    if (m_cfg.ponder == SearchConfig::PONDER_PREDICTED) {
+        TTEntry entry;
+        bool flip;
+        int reply = m_tt.probe(ttKey(s.hash(), s.mirrorHash(), m_cfg.symmetry, N, color, flip),
+                               entry) ? entry.move : 0;
+        if (flip && reply) reply = s.cols() + 1 - reply;
+        if (reply >= 1 && reply <= s.cols() && pos.makeMove(reply, color)) {
+            if (pos.state() != PLAYING) return;
+            color = (color == RED ? BLACK : RED);
+        }
+        // no expected reply: ponder on all of them
+    }
+    // The solver will take positions this small; nothing to prepare
+    if (m_cfg.solverMaxEmpty > 0 && pos.numberEmpty() <= m_cfg.solverMaxEmpty
+        && Solver::supports(pos.cols(), pos.levels(), N))
+        return;
+
+    m_ponderHash  = pos.hash();
+    m_ponderN     = N;
+    m_ponderColor = color;
+    m_ponderDone  = false;
+    m_pondering   = true;
+    m_stop        = false;
+    m_clock.start(0, 0);  // until stopped
+    m_tt.newSearch();
+    m_limits = m_tc;
+    m_ponderThread = thread([this, pos, N, color] {
+        findBestMove(pos, N, color);
+        lock_guard<mutex> lock(m_ponderMutex);
+        m_ponderDone = true;
+        m_ponderCv.notify_all();
+    });
+}
+
+void SmartPlayer::stopPondering() {
+    if (!m_ponderThread.joinable()) return;
+    m_stop = true;
+    m_ponderThread.join();
+    m_pondering = false;
+}
+
+// On a ponder hit, wait out the move's time (or the end of the search; 0 =
+// no time limit) and return the background search's move; 0 when there was
+// no hit.  A cancelled move stops waiting and takes the best move so far.
+int SmartPlayer::takePonderResult(const Scaffold& s, int N, int color, double waitMs) {
+    if (!m_ponderThread.joinable()) return 0;
+    if (s.hash() != m_ponderHash || N != m_ponderN || color != m_ponderColor)
+        return 0;
+    {
+        const chrono::duration<double, milli> slice(10);
+        auto until = chrono::steady_clock::now() + chrono::duration<double, milli>(waitMs);
+        unique_lock<mutex> lock(m_ponderMutex);
+        while (!m_ponderDone && !cancelled()) {
+            if (waitMs <= 0) {
+                m_ponderCv.wait_for(lock, slice);
+                continue;
+            }
+            auto now = chrono::steady_clock::now();
+            if (now >= until) break;
+            m_ponderCv.wait_for(lock, min<chrono::duration<double, milli>>(slice, until - now));
+        }
+    }
+    stopPondering();
+    if (m_ponderInfo.move == 0) return 0;
+    m_info = m_ponderInfo;
+    m_info.ponderHit = true;
+    if (!m_cfg.telemetryPath.empty()) writeTelemetry();
+    return m_info.move;
+}
+
+void SmartPlayer::setMoveBudget(int ms, long long nodes) {
+    TimeControl tc;
+    tc.moveTimeMs = max(0, ms);
+    tc.nodes      = nodes;
+    tc.depth      = m_tc.depth;
+    m_tc = tc;
+}
+
+void SmartPlayer::setTimeControl(const TimeControl& tc) {
+    m_tc = tc;
+}
+
+bool SmartPlayer::lastScore(int& score) const {
+    if (m_info.move == 0) return false;
+    score = m_info.score;
+    return true;
+}
+
+// The clock is read every SearchClock::CHECK_EVERY nodes (see miniMax), so
+// this is one relaxed load
+bool SmartPlayer::stopped() const {
+    return m_stop.load(memory_order_relaxed);
 }
 
-int SmartPlayer::findBestMove(const Scaffold& s, int N, int color, AlarmClock& ac) {
+// Lazy SMP: every thread runs its own iterative deepening on a private copy
+// of the position and they cooperate only through the shared, lock-free
+// transposition table.  Helpers start from a different root move and every
+// other helper searches one ply deeper, so they fill the table with results
+// the main thread is about to need.  Thread 0 decides when to stop; the
+// answer comes from whichever thread completed the deepest iteration.
+int SmartPlayer::findBestMove(const Scaffold& s, int N, int color) {
+    auto start = chrono::steady_clock::now();
+
+    // Center first, then outwards: 4 3 5 2 6 1 7 for seven columns
+    m_centerOrder.resize(s.cols());
+    for (int c = 1; c <= s.cols(); c++) m_centerOrder[c - 1] = c;
+    stable_sort(m_centerOrder.begin(), m_centerOrder.end(), [&](int a, int b) {
+        return abs(2 * a - s.cols() - 1) < abs(2 * b - s.cols() - 1);
+    });
+
+    int nThreads = max(1, m_cfg.threads);
+    bool nnue = m_nnue && m_nnue->matches(s.cols(), s.levels(), N);
+    while (static_cast<int>(m_threads.size()) < nThreads)
+        m_threads.emplace_back(new SearchThread(s));
+    for (int i = 0; i < nThreads; i++) {
+        SearchThread& t = *m_threads[i];
+        t.scaf = s;
+        t.scaf.setConnectN(N);  // keeps the Scaffold's state() exact
+        t.killers.assign(s.numberEmpty() + 2, {0, 0});
+        t.history.resize(3 * (s.cols() + 1));
+        for (int& h : t.history) h /= 2;  // keep, but fade, the last move's stats
+        if (t.moveBuf.size() < t.killers.size()) t.moveBuf.resize(t.killers.size());
+
+        // Evaluation windows follow the search's make/undo from here on
+        t.eval.reset(s.cols(), s.levels(), N, m_eval);
+        for (int c = 1; c <= s.cols(); c++)
+            for (int r = 1; r <= s.levels() && s.checkerAt(c, r) != VACANT; r++)
+                t.eval.play(c, s.checkerAt(c, r));
+        if (nnue) {
+            t.nnue.reset(m_nnue.get());
+            for (int c = 1; c <= s.cols(); c++)
+                for (int r = 1; r <= s.levels() && s.checkerAt(c, r) != VACANT; r++)
+                    t.nnue.play(c, s.checkerAt(c, r));
+        }
+        t.stats = SearchStats();
+        t.completedDepth = 0;
+        t.bestMove = 0;
+        t.bestScore = 0;
+    }
+
+    // Search on a compile-time sized board when there is one for this size,
+    // evaluated by the network when there is one for it
+    auto run = [&](auto* board) {
+        using Board = typename remove_pointer<decltype(board)>::type;
+        vector<thread> helpers;
+        for (int i = 1; i < nThreads; i++)
+            helpers.emplace_back([this, i, N, color] {
+                runThread<Board>(*m_threads[i], i, N, color);
+            });
+        runThread<Board>(*m_threads[0], 0, N, color);
+        m_stop = true;
+        for (thread& h : helpers) h.join();
+    };
+    auto search = [&](auto* board) {
+        using Base = typename remove_pointer<decltype(board)>::type;
+        if (nnue) run(static_cast<NnueBoard<Base>*>(nullptr));
+        else      run(board);
+    };
+    if (!m_cfg.fixedEngine || !withFixedScaffold(s.cols(), s.levels(), N, search))
+        search(static_cast<DynamicBoard*>(nullptr));
+
+    // A background search reports to takePonderResult instead
+    SearchInfo& info = m_pondering ? m_ponderInfo : m_info;
+    const SearchThread* best = m_threads[0].get();
+    info = SearchInfo();
+    for (int i = 0; i < nThreads; i++) {
+        const SearchThread& t = *m_threads[i];
+        info.add(t.stats);
+        if (t.completedDepth > best->completedDepth) best = &t;
+    }
+    info.depth    = best->completedDepth;
+    info.move     = best->bestMove;
+    info.score    = best->bestScore;
+    info.threads  = nThreads;
+    info.timedOut = m_clock.expired();
+    info.softMs   = m_clock.softMs();
+    info.hardMs   = m_clock.hardMs();
+    info.ms       = chrono::duration<double, milli>(
+                        chrono::steady_clock::now() - start).count();
+    info.nps      = info.ms > 0 ? info.nodes * 1000.0 / info.ms : 0;
+    if (!m_pondering && !m_cfg.telemetryPath.empty()) writeTelemetry();
+    return best->bestMove;
+}
+
+void SmartPlayer::writeTelemetry() {
+    if (!m_telemetry)
+        m_telemetry.reset(new ofstream(m_cfg.telemetryPath, ios::app));
+    const SearchInfo& i = m_info;
+    *m_telemetry << "{\"player\":\"" << m_name << "\",\"move\":" << i.move
+        << ",\"score\":" << i.score << ",\"depth\":" << i.depth
+        << ",\"threads\":" << i.threads << ",\"nodes\":" << i.nodes
+        << ",\"ms\":" << i.ms << ",\"nps\":" << static_cast<long long>(i.nps)
+        << ",\"beta_cutoffs\":" << i.betaCutoffs
+        << ",\"first_move_cutoff_rate\":"
+        << (i.betaCutoffs ? double(i.firstMoveCutoffs) / i.betaCutoffs : 0.0)
+        << ",\"tt_probes\":" << i.ttProbes << ",\"tt_hits\":" << i.ttHits
+        << ",\"eval_ms\":" << i.evalNs / 1e6
+        << ",\"win_check_ms\":" << i.winCheckNs / 1e6
+        << ",\"soft_ms\":" << i.softMs << ",\"hard_ms\":" << i.hardMs
+        << ",\"timed_out\":" << (i.timedOut ? "true" : "false")
+        << ",\"book\":" << (i.fromBook ? "true" : "false")
+        << ",\"solved\":" << (i.solved ? "true" : "false")
+        << ",\"ponder_hit\":" << (i.ponderHit ? "true" : "false") << "}\n";
+    m_telemetry->flush();
+}
+
+template <class Board>
+void SmartPlayer::runThread(SearchThread& t, int idx, int N, int color) {
+    auto plain = [&](auto* board) {
+        using Plain = typename remove_pointer<decltype(board)>::type;
+        if constexpr (is_same<Plain, DynamicBoard>::value)
+            return DynamicBoard{t.scaf, t.eval, m_centerOrder};
+        else
+            return Plain(t.scaf, m_eval);
+    };
+    if constexpr (IsNnueBoard<Board>::value) {
+        Board b(plain(static_cast<typename Board::Plain*>(nullptr)), t.nnue);
+        searchRoot(t, b, idx, N, color);
+    } else {
+        Board b = plain(static_cast<Board*>(nullptr));
+        searchRoot(t, b, idx, N, color);
+    }
+}
+
+// Make a move on the thread's board and evaluation together, timing the two
+// halves on one node in 64 (see SearchStats)
+template <class Board>
+void SmartPlayer::play(SearchThread& t, Board& b, int col, int color) {
+    if ((t.stats.nodes & 63) != 0) {
+        b.makeMove(col, color);
+        b.evalPlay(col, color);
+        return;
+    }
+    auto t0 = chrono::steady_clock::now();
+    b.makeMove(col, color);
+    auto t1 = chrono::steady_clock::now();
+    b.evalPlay(col, color);
+    auto t2 = chrono::steady_clock::now();
+    t.stats.winCheckNs += 64 * chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count();
+    t.stats.evalNs     += 64 * chrono::duration_cast<chrono::nanoseconds>(t2 - t1).count();
+}
+
+// Iterative deepening: search the root to depth 1, 2, 3, ... and keep the
+// best move of the deepest iteration that finished before the clock ran out.
+// Each iteration starts with the previous best move, which together with
+// the transposition table makes re-searching the shallower plies cheap.
+// With an aspiration window, an iteration first searches a narrow window
+// around the last score; a result outside it is only a bound, so the
+// iteration is repeated with that side widened (doubling each time) until
+// the score lands inside.
+template <class Board>
+void SmartPlayer::searchRoot(SearchThread& t, Board& b, int idx, int N, int color) {
     int opp = (color == RED ? BLACK : RED);
-    int bestScore = -INF, alpha = -INF, beta = +INF;
-    vector<int> bestMoves;
-    Scaffold scaf = s;
 
-    for (int c = 1; c <= s.cols(); c++) {
-        if (ac.timedOut()) break;
-        if (!scaf.makeMove(c, color)) continue;
+    // On a symmetric board a move and its mirror image score the same
+    bool symmetric = m_cfg.symmetry && b.hash() == b.mirrorHash();
+    vector<int> rootMoves;
+    for (int c : b.centerOrder())
+        if (!b.isFull(c) && !(symmetric && c > b.cols() + 1 - c)) rootMoves.push_back(c);
+    if (rootMoves.empty()) return;
+
+    if (m_cfg.threats) {
+        auto th = b.threats(color);
+        if (th.win) {  // nothing to search
+            t.completedDepth = 1;
+            t.bestMove  = th.win;
+            t.bestScore = WIN - 1;
+            return;
+        }
+        // Only the block, or only moves that don't hand the opponent a win
+        // (unless every move does)
+        vector<int> safe;
+        for (int c : rootMoves)
+            if (th.blocks ? c == th.block : !th.givesAway(c)) safe.push_back(c);
+        if (!safe.empty()) rootMoves.swap(safe);
+    }
+    if (idx > 0)
+        rotate(rootMoves.begin(),
+               rootMoves.begin() + idx % rootMoves.size(), rootMoves.end());
 
-        int score = -miniMax(scaf, N, opp, 1, -beta, -alpha, ac);
-        scaf.undoMove();
+    t.bestMove = rootMoves.front();
+    int maxDepth = b.numberEmpty();
+    if (m_limits.depth > 0) maxDepth = min(maxDepth, m_limits.depth);
+    int stable = 0;  // iterations in a row that kept the best move
 
-        if (score > bestScore) {
-            bestScore = score;
-            bestMoves = {c};
-        } else if (score == bestScore) {
-            bestMoves.push_back(c);
+    for (int d = 1 + (idx % 2); d <= maxDepth; d++) {
+        int delta = m_cfg.aspiration;
+        int alpha = -INF, beta = +INF;
+        if (delta > 0 && t.completedDepth > 0 && abs(t.bestScore) <= WIN / 2) {
+            alpha = t.bestScore - delta;
+            beta  = t.bestScore + delta;
         }
+        int iterBest = 0, iterScore = -INF;
+
+        for (;;) {
+            iterBest  = 0;
+            iterScore = -INF;
+            t.hitHorizon = false;
+            int a = alpha;
+            for (int c : rootMoves) {
+                play(t, b, c, color);
+                int score;
+                if (m_cfg.pvs && iterBest) {
+                    score = -miniMax(t, b, N, opp, 1, d - 1, -a - 1, -a);
+                    if (score > a && score < beta && !stopped())
+                        score = -miniMax(t, b, N, opp, 1, d - 1, -beta, -a);
+                } else {
+                    score = -miniMax(t, b, N, opp, 1, d - 1, -beta, -a);
+                }
+                b.evalUndo(c, color);
+                b.undoMove(c);
+                if (stopped()) break;
+
+                if (score > iterScore) { iterScore = score; iterBest = c; }
+                a = max(a, iterScore);
+                if (a >= beta) break;  // fails high; only inside an aspiration window
+            }
+            if (stopped()) break;
 
-        alpha = max(alpha, bestScore);
+            // Widen the side the score fell out of; past a win score, open it
+            if (iterScore <= alpha && alpha > -INF) {
+                delta *= 2;
+                alpha = iterScore - delta < -WIN / 2 ? -INF : iterScore - delta;
+            } else if (iterScore >= beta && beta < INF) {
+                delta *= 2;
+                beta = iterScore + delta > WIN / 2 ? INF : iterScore + delta;
+            } else {
+                break;
+            }
+        }
+        if (stopped()) break;  // partial iteration: keep the previous answer
+
+        int prevScore = t.bestScore;
+        stable = d > 1 && iterBest == t.bestMove ? stable + 1 : 0;
+        t.completedDepth = d;
+        t.bestMove  = iterBest;
+        t.bestScore = iterScore;
+        rotate(rootMoves.begin(),
+               find(rootMoves.begin(), rootMoves.end(), iterBest),
+               find(rootMoves.begin(), rootMoves.end(), iterBest) + 1);
+
+        // A proven result, or a tree searched to the end, won't change
+        if (abs(iterScore) > WIN / 2 || !t.hitHorizon) break;
+
+        // On a game clock thread 0 ends the search between iterations: early
+        // once the best move has held for a while, late while it keeps
+        // changing or the score is falling.  An iteration costs more than all
+        // the earlier ones together, so none starts past half the target.
+        if (idx == 0 && m_clock.softMs() < m_clock.hardMs()) {
+            double scale = stable >= 3 ? 0.5 : stable >= 1 ? 0.8 : 1.3;
+            if (d > 1 && iterScore < prevScore - SCORE_DROP) scale *= 1.5;
+            if (m_clock.pastSoft(scale / 2)) break;
+        }
     }
+}
 
-    if (bestMoves.empty()) return 0;
-    return bestMoves.front();  // Could randomize for variety
+// Order the legal moves at `depth`: the table's best move, then the two
+// killer moves of this ply, then by history score; columns nobody has an
+// opinion about stay in center-first order.  With threats, a forced block is
+// the only move and moves under an opponent's winning cell are left out.
+// With symmetry, a symmetric board keeps only the left one of each mirror
+// pair.
+template <class Board>
+void SmartPlayer::orderMoves(SearchThread& t, const Board& b, int color, int depth,
+                             int ttMove, const typename Board::Threats* th,
+                             vector<pair<int,int>>& out) {
+    const array<int,2>& killers = t.killers[depth];
+    const int* history = &t.history[color * (b.cols() + 1)];
+    bool symmetric = m_cfg.symmetry && b.hash() == b.mirrorHash();
+    out.clear();
+    for (int c : b.centerOrder()) {
+        if (b.isFull(c)) continue;
+        if (symmetric && c > b.cols() + 1 - c) continue;
+        if (th && (th->blocks ? c != th->block : th->givesAway(c))) continue;
+        int key = c == ttMove       ? (1 << 30)
+                : c == killers[0]   ? (1 << 29)
+                : c == killers[1]   ? (1 << 28)
+                :                     history[c];
+        // insertion sort, stable so ties keep the center-first order
+        out.push_back({key, c});
+        for (size_t i = out.size() - 1; i > 0 && out[i - 1].first < out[i].first; i--)
+            swap(out[i - 1], out[i]);
+    }
 }
 
-int SmartPlayer::miniMax(Scaffold& s, int N, int color, int depth,
-                         int alpha, int beta, AlarmClock& ac) {
-    if (ac.timedOut()) return 0;
+template <class Board>
+int SmartPlayer::miniMax(SearchThread& t, Board& b, int N, int color, int depth,
+                         int draft, int alpha, int beta) {
+    if (stopped()) return 0;
+    t.stats.nodes++;
+    if ((t.stats.nodes & (SearchClock::CHECK_EVERY - 1)) == 0
+        && (m_clock.checkHard() || cancelled()))
+        m_stop = true;  // out of time, or called off
+    if (m_limits.nodes > 0 && t.stats.nodes * max(1, m_cfg.threads) >= m_limits.nodes)
+        m_stop = true;  // node budget spent; this iteration is discarded
 
-    int eval = evaluateState(s, N, color, depth, ac);
+    int eval = evaluateState(t, b, color, depth, draft);
     if (eval != INT_MIN) return eval;
 
+    // Reuse an earlier result for this position if it was searched deep enough
+    bool flip;
+    uint64_t key = ttKey(b.hash(), b.mirrorHash(), m_cfg.symmetry, N, color, flip);
+    TTEntry entry;
+    int ttMove = 0;
+    t.stats.ttProbes++;
+    if (m_tt.probe(key, entry)) {
+        t.stats.ttHits++;
+        ttMove = flip && entry.move ? b.cols() + 1 - entry.move : entry.move;
+        if (entry.depth >= draft) {
+            int score = scoreFromTT(entry.score, depth);
+            TranspositionTable::Bound bound = TranspositionTable::boundOf(entry);
+            if (abs(score) <= WIN / 2) t.hitHorizon = true;  // may hide a horizon
+            if (bound == TranspositionTable::EXACT) return score;
+            if (bound == TranspositionTable::LOWER && score >= beta) return score;
+            if (bound == TranspositionTable::UPPER && score <= alpha) return score;
+        }
+    }
+
+    // Immediate wins and double threats decide the node without a search;
+    // a single threat leaves one move to try
+    typename Board::Threats th;
+    if (m_cfg.threats) {
+        th = b.threats(color);
+        if (th.win) return WIN - depth - 1;
+        if (th.blocks > 1) return -WIN + depth + 2;
+    }
+
     int opp = (color == RED ? BLACK : RED);
-    int best = -INF;
+    int alphaOrig = alpha;
+    int best = -INF, bestMove = 0;
+    // Scores here are fail-soft (a bound beyond the window, not the window's
+    // edge), which keeps table entries as tight as the search allows
 
-    for (int c = 1; c <= s.cols(); c++) {
-        if (ac.timedOut()) break;
-        if (!s.makeMove(c, color)) continue;
+    vector<pair<int,int>>& moves = t.moveBuf[depth];
+    orderMoves(t, b, color, depth, ttMove, m_cfg.threats ? &th : nullptr, moves);
+    if (moves.empty()) return -WIN + depth + 2;  // every move loses at once
+    for (const auto& m : moves) {
+        int c = m.second;
+        if (stopped()) break;
+        play(t, b, c, color);
 
-        int score = -miniMax(s, N, opp, depth + 1, -beta, -alpha, ac);
-        s.undoMove();
+        // PVS: the first move sets the bar and the rest only need to prove
+        // they can't beat it, with a zero window; one that does is searched
+        // again with the full window for its real score
+        int score;
+        if (m_cfg.pvs && bestMove) {
+            score = -miniMax(t, b, N, opp, depth + 1, draft - 1, -alpha - 1, -alpha);
+            if (score > alpha && score < beta && !stopped())
+                score = -miniMax(t, b, N, opp, depth + 1, draft - 1, -beta, -alpha);
+        } else {
+            score = -miniMax(t, b, N, opp, depth + 1, draft - 1, -beta, -alpha);
+        }
+        b.evalUndo(c, color);
+        b.undoMove(c);
 
-        best = max(best, score);
+        if (score > best) { best = score; bestMove = c; }
         alpha = max(alpha, best);
-        if (alpha >= beta) break;  // Alpha-beta pruning
+        if (alpha >= beta) {  // Alpha-beta pruning
+            t.stats.betaCutoffs++;
+            if (&m == &moves.front()) t.stats.firstMoveCutoffs++;
+            array<int,2>& killers = t.killers[depth];
+            if (killers[0] != c) { killers[1] = killers[0]; killers[0] = c; }
+            t.history[color * (b.cols() + 1) + c] += draft * draft;
+            break;
+        }
     }
 
+    // A search cut short by the clock is incomplete; don't remember it
+    if (!stopped()) {
+        int move = flip && bestMove ? b.cols() + 1 - bestMove : bestMove;
+        TranspositionTable::Bound bound =
+            best <= alphaOrig ? TranspositionTable::UPPER
+          : best >= beta      ? TranspositionTable::LOWER
+          :                     TranspositionTable::EXACT;
+        m_tt.store(key, draft, bound, scoreToTT(best, depth), move);
+    }
     return best;
 }
 
-int SmartPlayer::evaluateState(const Scaffold& s, int N, int color, int depth, AlarmClock& ac) {
-    if (ac.timedOut()) return 0;
+template <class Board>
+int SmartPlayer::evaluateState(SearchThread& t, Board& b, int color, int depth,
+                               int draft) {
+    if (stopped()) return 0;
 
-    GameState gs = checkState(s, N);
+    GameState gs = b.state();
     if (gs == PLAYING) {
-        // Heuristic evaluation for non-terminal state
-        return heuristicScore(s, N, color);
+        if (draft > 0) return INT_MIN;  // keep searching
+        // Heuristic evaluation for non-terminal state; the board's evaluation
+        // follows its moves, so this equals heuristicScore(board, N, color)
+        t.hitHorizon = true;
+        return b.evalScore(color);
     }
 
     if ((gs == REDWIN && color == RED) || (gs == BLACKWIN && color == BLACK))
-        return 100000 - depth;
+        return WIN - depth;
     if ((gs == REDWIN && color == BLACK) || (gs == BLACKWIN && color == RED))
-        return -100000 + depth;
+        return -WIN + depth;
 
     return 0;  // TIE
 }
 
-int SmartPlayer::heuristicScore(const Scaffold& s, int N, int color) {
+int SmartPlayer::heuristicScore(const Scaffold& s, int N, int color, const EvalParams& p) {
+    if (N < 1 || N > EvalKernel::MAX_N) return heuristicScoreScalar(s, N, color, p);
+    EvalTerms t[2];
+    EvalKernel::terms(s, N, t);
+    return p.score(t[color == RED ? 0 : 1], t[color == RED ? 1 : 0], N);
+}
+
+int SmartPlayer::heuristicScoreScalar(const Scaffold& s, int N, int color,
+                                      const EvalParams& p) {
     int opp = (color == RED ? BLACK : RED);
 
     // Pre-compute current height of each column to reason about reachability of
@@ -124,7 +820,7 @@ int SmartPlayer::heuristicScore(const Scaffold& s, int N, int color) {
     }
 
     auto scoreLine = [&](int c, int r, int dc, int dr, int col) {
-        int countColor = 0, countEmpty = 0;
+        int countColor = 0;
         for (int i = 0; i < N; ++i) {
             int cc = c + i * dc, rr = r + i * dr;
             if (cc < 1 || cc > s.cols() || rr < 1 || rr > s.levels()) return 0;
@@ -135,16 +831,15 @@ int SmartPlayer::heuristicScore(const Scaffold& s, int N, int color) {
                 // If this cell is not immediately reachable, the pattern is
                 // unlikely to be completed soon, so disregard this line.
                 if (rr > height[cc] + 1) return 0;
-                countEmpty++;
             } else {
                 // Blocked by the opponent
                 return 0;
             }
         }
-        return (countColor == 0 ? 0 : (countColor * countColor + countEmpty));
+        return (countColor == 0 ? 0 : p.window(countColor, N));
     };
 
-    int score = 0;
+    long long score = p.tempo;
     const vector<pair<int,int>> dirs = {{1,0},{0,1},{1,1},{1,-1}};
     for (int c = 1; c <= s.cols(); ++c) {
         for (int r = 1; r <= s.levels(); ++r) {
@@ -154,10 +849,13 @@ int SmartPlayer::heuristicScore(const Scaffold& s, int N, int color) {
             }
         }
     }
-    return score;
+    return static_cast<int>(score / EvalParams::SCALE);
 }
 
 GameState SmartPlayer::checkState(const Scaffold& s, int N) {
+    if (s.connectN() == N) return s.state();
+
+    // Scaffold tracks a different win length; fall back to a full scan.
     auto inBounds = [&](int c, int r) {
         return c >= 1 && c <= s.cols() && r >= 1 && r <= s.levels();
     };
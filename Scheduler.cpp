@@ -0,0 +1,141 @@
+// Scheduler.cpp
+#include "Scheduler.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+//––– WorkerPool –––––––––––––––––––––––––––––––––––––––––––––––––––––––––––
+WorkerPool::WorkerPool(int threads) {
+    int n = threads > 0 ? threads
+                        : max(1, static_cast<int>(thread::hardware_concurrency()));
+    for (int i = 0; i < n; i++)
+        m_threads.emplace_back([this] { run(); });
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    for (thread& t : m_threads) t.join();
+}
+
+void WorkerPool::post(function<void()> task) {
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_cv.notify_one();
+}
+
+void WorkerPool::run() {
+    for (;;) {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty()) return;
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+//––– GameScheduler ––––––––––––––––––––––––––––––––––––––––––––––––––––––––
+GameScheduler::GameScheduler(const SchedulerConfig& cfg)
+  : m_cfg(cfg), m_pool(cfg.threads) {
+    const TimeControl& b = cfg.budget;
+    m_budgeted = b.clockMs > 0 || b.moveTimeMs > 0 || b.nodes > 0 || b.depth > 0;
+}
+
+GameScheduler::~GameScheduler() {
+    cancel();
+    wait();
+}
+
+void GameScheduler::add(Game& game, Done done) {
+    shared_ptr<Entry> e(new Entry{&game, std::move(done), Clock::now()});
+    {
+        lock_guard<mutex> lock(m_mutex);
+        if (m_stats.games++ == 0) m_start = e->queued;
+        m_active++;
+    }
+    m_pool.post([this, e] { step(e); });
+}
+
+void GameScheduler::cancel() {
+    m_cancel.cancel();
+}
+
+void GameScheduler::wait() {
+    unique_lock<mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_active == 0; });
+}
+
+// One turn of one game, then the next turn goes to the back of the queue
+void GameScheduler::step(const shared_ptr<Entry>& e) {
+    Game::Turn t;
+    if (m_cancel.cancelled() || !e->game->nextTurn(t)) {
+        finish(e);
+        return;
+    }
+    const TimeControl* budget = t.timed ? &t.budget : m_budgeted ? &m_cfg.budget : nullptr;
+    Clock::time_point start = Clock::now();
+    int col = t.player->chooseMoveCancellable(*t.position, t.N, t.color, budget, m_cancel);
+    Clock::time_point end = Clock::now();
+    if (m_cancel.cancelled()) {  // the move may be a half-finished search's
+        finish(e);
+        return;
+    }
+    e->game->playTurn(col, static_cast<int>(
+                               chrono::duration_cast<chrono::milliseconds>(end - start).count()));
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stats.moves++;
+        m_latencies.push_back(chrono::duration<float, milli>(end - e->queued).count());
+        m_thinkMs += chrono::duration<double, milli>(end - start).count();
+        m_last = end;
+    }
+    e->queued = Clock::now();
+    m_pool.post([this, e] { step(e); });
+}
+
+void GameScheduler::finish(const shared_ptr<Entry>& e) {
+    int winner = VACANT;
+    bool over = e->game->completed(winner);
+    if (e->done) e->done(*e->game, over ? winner : VACANT);
+    lock_guard<mutex> lock(m_mutex);
+    if (over) m_stats.finished++;
+    m_last = Clock::now();
+    if (--m_active == 0) m_idle.notify_all();
+}
+
+// Nearest-rank percentiles over every move played so far
+SchedulerStats GameScheduler::stats() const {
+    SchedulerStats st;
+    vector<float> ms;
+    {
+        lock_guard<mutex> lock(m_mutex);
+        st = m_stats;
+        ms = m_latencies;
+        st.thinkMs = st.moves ? m_thinkMs / st.moves : 0;
+        if (st.games)
+            st.seconds = chrono::duration<double>(
+                             (m_active ? Clock::now() : m_last) - m_start).count();
+    }
+    st.movesPerSec = st.seconds > 0 ? st.moves / st.seconds : 0;
+    if (ms.empty()) return st;
+    sort(ms.begin(), ms.end());
+    auto rank = [&](double p) {
+        size_t k = static_cast<size_t>(ceil(p * ms.size()));
+        return static_cast<double>(ms[min(ms.size(), max<size_t>(k, 1)) - 1]);
+    };
+    st.p50   = rank(0.50);
+    st.p90   = rank(0.90);
+    st.p99   = rank(0.99);
+    st.maxMs = ms.back();
+    return st;
+}
@@ -0,0 +1,115 @@
+// Scheduler.h
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "GameCore.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//––– WorkerPool: a fixed set of threads running queued tasks ––––––––––––––
+// Tasks run in the order they were posted, each on whichever thread is
+// free first.
+class WorkerPool {
+  public:
+    explicit WorkerPool(int threads = 0);  // 0 = one per hardware thread
+    // Runs every task already posted, then joins the threads
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void post(std::function<void()> task);
+    int  size() const { return static_cast<int>(m_threads.size()); }
+
+  private:
+    void run();
+
+    std::vector<std::thread>           m_threads;
+    std::deque<std::function<void()>>  m_tasks;
+    std::mutex                         m_mutex;
+    std::condition_variable            m_cv;
+    bool                               m_stopping = false;
+};
+
+//––– GameScheduler: many Games at once on a few threads –––––––––––––––––––
+// Every game is a chain of pool tasks.  A task asks the side to move for
+// one move (Game::nextTurn, Player::chooseMoveCancellable), plays it
+// (Game::playTurn) and posts the game's next turn behind every other
+// game's, so thousands of games take turns on the pool's threads without
+// one holding a thread while it waits.  A game's players are asked for
+// one move at a time, but a player must not be shared with another game
+// running at once; pondering players start threads of their own and are
+// best left off here.
+struct SchedulerConfig {
+    int         threads = 0;  // pool size, 0 = one per hardware thread
+    TimeControl budget;       // handed to players before every move of a
+                              // game without its own time control; all
+                              // zero = players keep their own limits
+};
+
+struct SchedulerStats {
+    long long games = 0, finished = 0;  // added, and played to the end
+    long long moves = 0;
+    double    seconds     = 0;          // from the first game added to the
+                                        // last move (or now, while running)
+    double    movesPerSec = 0;
+    double    p50 = 0, p90 = 0, p99 = 0, maxMs = 0;  // per move, from the
+                                                     // turn being queued to
+                                                     // the move being played
+    double    thinkMs = 0;              // mean time inside chooseMove
+};
+
+class GameScheduler {
+  public:
+    // Called once per game, from a pool thread, when it has ended; winner
+    // as Game::completed gives it, or VACANT for a game cut short by cancel
+    using Done = std::function<void(Game& game, int winner)>;
+
+    explicit GameScheduler(const SchedulerConfig& cfg = SchedulerConfig());
+    // Cancels what is still running and waits for it
+    ~GameScheduler();
+    GameScheduler(const GameScheduler&) = delete;
+    GameScheduler& operator=(const GameScheduler&) = delete;
+
+    // Start playing `game`, which must stay alive until it is done
+    void add(Game& game, Done done = Done());
+    // Stop every game: moves being thought about are abandoned and no new
+    // turns start
+    void cancel();
+    // Block until every game added so far is done
+    void wait();
+    SchedulerStats stats() const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        Game*             game;
+        Done              done;
+        Clock::time_point queued;  // when its current turn was posted
+    };
+
+    void step(const std::shared_ptr<Entry>& e);
+    void finish(const std::shared_ptr<Entry>& e);
+
+    SchedulerConfig          m_cfg;
+    bool                     m_budgeted;  // m_cfg.budget has a limit in it
+    CancelToken              m_cancel;
+
+    mutable std::mutex       m_mutex;
+    std::condition_variable  m_idle;
+    long long                m_active = 0;
+    SchedulerStats           m_stats;
+    std::vector<float>       m_latencies;  // ms per move
+    double                   m_thinkMs = 0;
+    Clock::time_point        m_start, m_last;  // first game added, last move
+
+    WorkerPool               m_pool;  // last, so it stops first
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,365 @@
+// Solver.cpp
+#include "Solver.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+static const char kMagic[8] = { 'C', 'N', 'S', 'O', 'L', 'V', 'E', 0 };
+
+// Positions this many plies below the root are looked up in the database
+static const int kDbPlies = 6;
+
+static int countBits(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    int n = 0;
+    for (; x; x &= x - 1) n++;
+    return n;
+#endif
+}
+
+//––– SolveDatabase ––––––––––––––––––––––––––––––––––––––––––––––––––––––––
+bool SolveDatabase::open(const string& path, int cols, int levels, int N) {
+    m_path   = path;
+    m_cols   = cols;
+    m_levels = levels;
+    m_N      = N;
+    m_pending.clear();
+    if (remap()) return true;
+    m_path.clear();
+    return false;
+}
+
+// Map the current file; a missing file is an empty database
+bool SolveDatabase::remap() {
+    m_file.close();
+    m_records = nullptr;
+    m_count   = 0;
+    if (!m_file.open(m_path)) return !ifstream(m_path).good();
+
+    const char* base = m_file.data();
+    size_t      len  = m_file.size();
+    const SolveHeader* h = reinterpret_cast<const SolveHeader*>(base);
+    if (len < sizeof(SolveHeader) || memcmp(h->magic, kMagic, 8) != 0
+        || h->version != VERSION || h->cols != m_cols
+        || h->levels != m_levels || h->N != m_N
+        || h->count > (len - sizeof(SolveHeader)) / sizeof(SolveRecord)) {
+        m_file.close();
+        return false;
+    }
+    m_records = reinterpret_cast<const SolveRecord*>(base + sizeof(SolveHeader));
+    m_count   = static_cast<size_t>(h->count);
+    return true;
+}
+
+bool SolveDatabase::lookup(uint64_t key, int& score) const {
+    const SolveRecord* end = m_records + m_count;
+    const SolveRecord* it = lower_bound(m_records, end, key,
+        [](const SolveRecord& r, uint64_t k) { return r.key < k; });
+    if (it != end && it->key == key) {
+        score = it->score;
+        return true;
+    }
+    auto p = m_pending.find(key);
+    if (p == m_pending.end()) return false;
+    score = p->second;
+    return true;
+}
+
+void SolveDatabase::record(uint64_t key, int score) {
+    int known;
+    if (!isOpen() || lookup(key, known)) return;
+    m_pending[key] = score;
+    if (m_pending.size() >= FLUSH_EVERY) flush();
+}
+
+// Merge the pending records into the newest version of the file.  Writers
+// take turns under the lock, each re-reading the file first, so none of
+// them drops another's records; readers only ever map a whole file.
+bool SolveDatabase::flush() {
+    if (!isOpen() || m_pending.empty()) return true;
+    FileLock lock(m_path);
+    remap();  // pick up records other processes have added meanwhile
+
+    vector<SolveRecord> all(m_records, m_records + m_count);
+    for (const auto& p : m_pending) {
+        SolveRecord r;
+        memset(&r, 0, sizeof r);
+        r.key   = p.first;
+        r.score = p.second;
+        all.push_back(r);
+    }
+    stable_sort(all.begin(), all.end(), [](const SolveRecord& a, const SolveRecord& b) {
+        return a.key < b.key;
+    });
+    all.erase(unique(all.begin(), all.end(),
+                     [](const SolveRecord& a, const SolveRecord& b) { return a.key == b.key; }),
+              all.end());
+
+    SolveHeader h;
+    memset(&h, 0, sizeof h);
+    memcpy(h.magic, kMagic, 8);
+    h.version = VERSION;
+    h.cols    = static_cast<uint16_t>(m_cols);
+    h.levels  = static_cast<uint16_t>(m_levels);
+    h.N       = static_cast<uint16_t>(m_N);
+    h.count   = all.size();
+
+    string tmp = MappedFile::tempName(m_path);
+    {
+        ofstream out(tmp, ios::binary | ios::trunc);
+        out.write(reinterpret_cast<const char*>(&h), sizeof h);
+        out.write(reinterpret_cast<const char*>(all.data()),
+                  all.size() * sizeof(SolveRecord));
+        if (!out) {
+            out.close();
+            remove(tmp.c_str());
+            return false;
+        }
+    }
+    m_file.close();
+    m_records = nullptr;
+    m_count   = 0;
+    if (!MappedFile::replace(tmp, m_path)) {
+        remove(tmp.c_str());
+        remap();
+        return false;
+    }
+    m_pending.clear();
+    return remap();
+}
+
+//––– Solver –––––––––––––––––––––––––––––––––––––––––––––––––––––––––––––––
+Solver::Solver(int cols, int levels, int N, int tableLog2)
+  : m_cols(cols), m_levels(levels), m_N(N), m_stride(levels + 1),
+    m_bottom(0), m_columnMask((uint64_t(1) << levels) - 1)
+{
+    for (int c = 0; c < cols; c++) m_bottom |= uint64_t(1) << (c * m_stride);
+    m_board = m_bottom * m_columnMask;
+
+    // Center first, then outwards
+    for (int c = 0; c < cols; c++) m_order.push_back(c);
+    stable_sort(m_order.begin(), m_order.end(), [&](int a, int b) {
+        return abs(2 * a - cols + 1) < abs(2 * b - cols + 1);
+    });
+
+    m_table.resize(size_t(1) << tableLog2);
+    m_tableMask = m_table.size() - 1;
+}
+
+// Empty cells that would complete a line of N for the checkers in `pos`:
+// for each direction, a cell wins when a checkers lie next to it on one
+// side and N-1-a on the other
+uint64_t Solver::winning(uint64_t pos, uint64_t mask) const {
+    auto shl = [](uint64_t x, int n) { return n < 64 ? x << n : 0; };
+    auto shr = [](uint64_t x, int n) { return n < 64 ? x >> n : 0; };
+    const int steps[4] = { 1, m_stride, m_stride + 1, m_stride - 1 };
+    uint64_t below[16], above[16];
+    uint64_t r = 0;
+    for (int d : steps) {
+        below[0] = above[0] = ~uint64_t(0);
+        for (int k = 1; k < m_N; k++) {
+            below[k] = below[k - 1] & shl(pos, k * d);
+            above[k] = above[k - 1] & shr(pos, k * d);
+        }
+        for (int a = 0; a < m_N; a++) r |= below[a] & above[m_N - 1 - a];
+    }
+    return r & (m_board ^ mask);
+}
+
+uint64_t Solver::mirror(uint64_t x) const {
+    const uint64_t all = (m_columnMask << 1) | 1;  // a column and its sentinel
+    uint64_t r = 0;
+    for (int c = 0; c < m_cols; c++)
+        r |= ((x >> (c * m_stride)) & all) << ((m_cols - 1 - c) * m_stride);
+    return r;
+}
+
+// current + mask is unique per position: each column reads as its height
+// bit plus the side to move's checkers below it.  Carries stay within a
+// column, so mirroring the sum is the sum of the mirrors.
+uint64_t Solver::canonicalKey(uint64_t current, uint64_t mask) const {
+    uint64_t key = current + mask;
+    return min(key, mirror(key));
+}
+
+// Bit masks of `s` with `color` to move.  True, with the score, if the game
+// is already over.
+bool Solver::load(const Scaffold& s, int color, uint64_t& current, uint64_t& mask,
+                  int& moves, int& score) const {
+    Scaffold t(s);
+    t.setConnectN(m_N);
+    uint64_t red = t.colorBits(RED)[0], black = t.colorBits(BLACK)[0];
+    current = color == RED ? red : black;
+    mask    = red | black;
+    moves   = cells() - t.numberEmpty();
+    switch (t.state()) {
+      case PLAYING: return false;
+      case TIE:     score = 0; return true;
+      default: {
+        int win = (cells() + 2 - moves) / 2;  // won on the previous move
+        score = (t.state() == REDWIN) == (color == RED) ? win : -win;
+        return true;
+      }
+    }
+}
+
+bool Solver::solve(const Scaffold& s, int color, int& score, const AlarmClock* ac,
+                   const CancelToken* cancel) {
+    uint64_t current, mask;
+    int moves;
+    if (load(s, color, current, mask, moves, score)) return true;
+    m_ac = ac;
+    m_cancel = cancel;
+    m_stopped = false;
+    int v = solveRoot(current, mask, moves);
+    if (m_stopped) return false;
+    score = v;
+    return true;
+}
+
+int Solver::bestMove(const Scaffold& s, int color, int& score, const AlarmClock* ac,
+                     const CancelToken* cancel) {
+    uint64_t current, mask;
+    int moves;
+    if (load(s, color, current, mask, moves, score)) return 0;
+    m_ac = ac;
+    m_cancel = cancel;
+    m_stopped = false;
+
+    uint64_t possible = (mask + m_bottom) & m_board;
+    uint64_t wins = winning(current, mask) & possible;
+    for (int c : m_order)
+        if (wins & column(c)) {
+            score = (cells() + 1 - moves) / 2;
+            return c + 1;
+        }
+
+    // A mirror-symmetric position needs only one of each mirrored pair
+    bool symmetric = mirror(current + mask) == current + mask;
+    int best = 0, bestScore = INT_MIN;
+    for (int c : m_order) {
+        uint64_t mv = possible & column(c);
+        if (!mv || (symmetric && c > m_cols - 1 - c)) continue;
+        int v = -solveRoot(current ^ mask, mask | mv, moves + 1);
+        if (m_stopped) return 0;
+        if (v > bestScore) {
+            bestScore = v;
+            best = c + 1;
+        }
+    }
+    if (m_db) m_db->record(canonicalKey(current, mask), bestScore);
+    score = bestScore;
+    return best;
+}
+
+int Solver::lookupMove(const Scaffold& s, int color, int& score) {
+    if (!m_db) return 0;
+    m_dbOnly = true;
+    int move = bestMove(s, color, score);
+    m_dbOnly = false;
+    return move;
+}
+
+// Exact score by null-window probes, bisecting [min, max] towards 0 first
+// since most positions are close to a draw
+int Solver::solveRoot(uint64_t current, uint64_t mask, int moves) {
+    m_rootMoves = moves;
+    if (winning(current, mask) & (mask + m_bottom) & m_board)
+        return (cells() + 1 - moves) / 2;
+    uint64_t key = canonicalKey(current, mask);
+    int v;
+    if (m_db && m_db->lookup(key, v)) return v;
+    if (m_dbOnly) {
+        m_stopped = true;
+        return 0;
+    }
+
+    int lo = -(cells() - moves) / 2, hi = (cells() + 1 - moves) / 2;
+    while (lo < hi && !m_stopped) {
+        int med = lo + (hi - lo) / 2;
+        if (med <= 0 && lo / 2 < med)      med = lo / 2;
+        else if (med >= 0 && hi / 2 > med) med = hi / 2;
+        int r = negamax(current, mask, moves, med, med + 1);
+        if (r <= med) hi = r;
+        else          lo = r;
+    }
+    if (!m_stopped && m_db) m_db->record(key, lo);
+    return lo;
+}
+
+// Fail-soft alpha-beta.  The side to move cannot win immediately (callers
+// check), and only moves that do not let the opponent win at once are
+// tried, which keeps that true one ply down.
+int Solver::negamax(uint64_t current, uint64_t mask, int moves, int alpha, int beta) {
+    if ((++m_nodes & 4095) == 0
+        && ((m_ac && m_ac->timedOut()) || (m_cancel && m_cancel->cancelled())))
+        m_stopped = true;
+    if (m_stopped) return alpha;
+
+    uint64_t possible = (mask + m_bottom) & m_board;
+    uint64_t threats  = winning(current ^ mask, mask);
+    uint64_t forced   = possible & threats;
+    if (forced) {
+        if (forced & (forced - 1)) return -(cells() - moves) / 2;  // can't block both
+        possible = forced;
+    }
+    possible &= ~(threats >> 1);  // never play right under an opponent threat
+    if (!possible) return -(cells() - moves) / 2;
+    if (moves >= cells() - 2) return 0;
+
+    // Neither side can win within one move of here
+    int lo = -(cells() - 2 - moves) / 2, hi = (cells() - 1 - moves) / 2;
+    uint64_t key = canonicalKey(current, mask);
+    Entry& e = m_table[(key * 0x9E3779B97F4A7C15ULL >> 32) & m_tableMask];
+    if (e.key == key) {
+        lo = max(lo, int(e.lower));
+        hi = min(hi, int(e.upper));
+    }
+    int v;
+    if (m_db && moves <= m_rootMoves + kDbPlies && m_db->lookup(key, v)) return v;
+    if (alpha < lo) { alpha = lo; if (alpha >= beta) return alpha; }
+    if (beta > hi)  { beta = hi;  if (alpha >= beta) return beta; }
+
+    // Moves creating the most winning cells first, center first on ties
+    uint64_t moveBits[64];  // one per column, and the layout has at most 64
+    int      order[64];
+    int n = 0;
+    for (int c : m_order) {
+        uint64_t mv = possible & column(c);
+        if (!mv) continue;
+        int k = countBits(winning(current | mv, mask | mv));
+        int j = n++;
+        for (; j > 0 && order[j - 1] < k; j--) {
+            order[j]    = order[j - 1];
+            moveBits[j] = moveBits[j - 1];
+        }
+        order[j]    = k;
+        moveBits[j] = mv;
+    }
+
+    const int alpha0 = alpha;
+    int best = INT_MIN;
+    for (int i = 0; i < n; i++) {
+        v = -negamax(current ^ mask, mask | moveBits[i], moves + 1, -beta, -alpha);
+        if (m_stopped) return alpha;
+        if (v > best) best = v;
+        if (v > alpha) alpha = v;
+        if (alpha >= beta) break;
+    }
+
+    if (e.key != key) {
+        e.key   = key;
+        e.lower = INT8_MIN;
+        e.upper = INT8_MAX;
+    }
+    if (best >= beta)        e.lower = int8_t(max(int(e.lower), best));
+    else if (best <= alpha0) e.upper = int8_t(min(int(e.upper), best));
+    else                     e.lower = e.upper = int8_t(best);
+    return best;
+}
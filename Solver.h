@@ -0,0 +1,152 @@
+// Solver.h
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "GameCore.h"
+#include "MappedFile.h"
+
+//––– Solve database file format –––––––––––––––––––––––––––––––––––––––––––
+// Same shape as the opening book: a 32-byte header, then 16-byte records
+// sorted by key, mapped and binary-searched in place.  Keys are the
+// Solver's canonical position keys, so a position and its mirror image
+// share one record.
+struct SolveHeader {
+    char     magic[8];    // "CNSOLVE\0"
+    uint32_t version;
+    uint16_t cols, levels, N;
+    uint16_t reserved;
+    uint32_t reserved2;
+    uint64_t count;       // number of records
+};
+
+struct SolveRecord {
+    uint64_t key;         // Solver::canonicalKey of the position
+    int32_t  score;       // exact score for the side to move
+    uint32_t reserved;
+};
+
+static_assert(sizeof(SolveHeader) == 32, "solve header layout");
+static_assert(sizeof(SolveRecord) == 16, "solve record layout");
+
+//––– SolveDatabase: persistent exact scores –––––––––––––––––––––––––––––––
+// Reads go to the mapped file first, then to results recorded since it was
+// mapped.  New results are merged into the file (written aside and renamed
+// over it, so other processes keep a consistent view) every FLUSH_EVERY
+// records, on flush() and on destruction.
+class SolveDatabase {
+  public:
+    static const uint32_t VERSION = 1;
+    static const size_t   FLUSH_EVERY = 4096;
+
+    SolveDatabase() {}
+    ~SolveDatabase() { flush(); }
+    SolveDatabase(const SolveDatabase&) = delete;
+    SolveDatabase& operator=(const SolveDatabase&) = delete;
+
+    // Attach to `path` for this board; a missing file is created on the
+    // first flush.  False if the file exists but is not a database for
+    // this board.
+    bool open(const std::string& path, int cols, int levels, int N);
+
+    bool   isOpen() const { return !m_path.empty(); }
+    bool   lookup(uint64_t key, int& score) const;
+    void   record(uint64_t key, int score);
+    bool   flush();
+    size_t size() const      { return m_count + m_pending.size(); }
+    size_t fileBytes() const { return m_file.size(); }
+
+  private:
+    bool remap();
+
+    std::string                       m_path;
+    int                               m_cols = 0, m_levels = 0, m_N = 0;
+    MappedFile                        m_file;
+    const SolveRecord*                m_records = nullptr;
+    size_t                            m_count   = 0;
+    std::unordered_map<uint64_t, int> m_pending;  // not yet in the file
+};
+
+//––– Solver: exact game-theoretic values for small boards –––––––––––––––––
+// Works on boards whose padded layout fits one 64-bit word (7x6 and
+// smaller, or e.g. 8x6, 9x5), with the position held as the side to move's
+// checkers plus the occupied mask, in the Scaffold's bit layout.  Scores
+// follow the usual convention: 0 is a draw, a win scores (cells + 1 - m) / 2
+// where m is the number of checkers on the board before the winning move
+// (so faster wins score higher), and a loss is the negated opponent win.
+//
+// The search is a fail-soft alpha-beta driven by null-window probes that
+// bisect the score range.  It plays only moves that do not hand the
+// opponent an immediate win, orders them by how many winning cells they
+// create, and remembers bounds in a table keyed by the smaller of the
+// position's key and its mirror image's.  When a database is attached,
+// positions near the root are looked up there first and every solved root
+// is recorded.
+class Solver {
+  public:
+    Solver(int cols, int levels, int N, int tableLog2 = 20);
+
+    // Whether a board can be solved at all
+    static bool supports(int cols, int levels, int N) {
+        return cols >= 1 && levels >= 1 && N >= 1 && N <= 16
+               && cols * (levels + 1) <= 64;
+    }
+
+    bool matches(int cols, int levels, int N) const {
+        return cols == m_cols && levels == m_levels && N == m_N;
+    }
+    void setDatabase(SolveDatabase* db) { m_db = db; }
+
+    // Exact score of `s` with `color` to move.  False if `ac` ran out or
+    // `cancel` was set first.
+    bool solve(const Scaffold& s, int color, int& score,
+               const AlarmClock* ac = nullptr, const CancelToken* cancel = nullptr);
+
+    // A best column for `color` and its exact score; 0 if `ac` ran out or
+    // `cancel` was set
+    int  bestMove(const Scaffold& s, int color, int& score,
+                  const AlarmClock* ac = nullptr, const CancelToken* cancel = nullptr);
+
+    // Like bestMove, but only from the database: 0 unless every reply is
+    // already recorded there
+    int  lookupMove(const Scaffold& s, int color, int& score);
+
+    long long nodes() const { return m_nodes; }
+    int  cells() const      { return m_cols * m_levels; }
+
+    // Canonical (mirror-independent) key of a position
+    uint64_t canonicalKey(uint64_t current, uint64_t mask) const;
+
+  private:
+    struct Entry {
+        uint64_t key = 0;
+        int8_t   lower = INT8_MIN, upper = INT8_MAX;  // when key matches
+    };
+
+    bool     load(const Scaffold& s, int color, uint64_t& current, uint64_t& mask,
+                  int& moves, int& score) const;
+    int      solveRoot(uint64_t current, uint64_t mask, int moves);
+    int      negamax(uint64_t current, uint64_t mask, int moves, int alpha, int beta);
+    uint64_t winning(uint64_t pos, uint64_t mask) const;
+    uint64_t mirror(uint64_t x) const;
+    uint64_t column(int c) const { return m_columnMask << (c * m_stride); }
+
+    int       m_cols, m_levels, m_N, m_stride;
+    uint64_t  m_bottom, m_board, m_columnMask;
+    std::vector<int>   m_order;     // 0-based columns, center first
+    std::vector<Entry> m_table;
+    uint64_t  m_tableMask;
+    SolveDatabase*     m_db = nullptr;
+    const AlarmClock*  m_ac = nullptr;
+    const CancelToken* m_cancel = nullptr;
+    bool      m_stopped = false;
+    bool      m_dbOnly  = false;
+    long long m_nodes   = 0;
+    int       m_rootMoves = 0;
+};
+
+#endif // SOLVER_H
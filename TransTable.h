@@ -0,0 +1,129 @@
+// TransTable.h
+#ifndef TRANSTABLE_H
+#define TRANSTABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <memory>
+
+//––– TTEntry: one remembered search result, as returned by probe() ––––––
+struct TTEntry {
+    uint64_t key;       // full Zobrist key, 0 = empty slot
+    int32_t  score;
+    uint16_t move;      // best column found, 0 = none
+    uint8_t  depth;     // remaining draft the score was searched to
+    uint8_t  genBound;  // generation << 2 | bound
+};
+
+//––– TranspositionTable: fixed-size, 4-way set-associative cache ––––––––––
+// Each bucket holds four entries and occupies exactly one 64-byte cache
+// line, so a probe touches a single line.  Within a bucket an existing
+// entry for the same key is overwritten; otherwise the victim is the entry
+// with the lowest depth, with entries from older searches aged down so the
+// table does not fill up with stale deep results.
+//
+// The table is shared by all search threads without locks.  Every slot
+// stores its payload word and the key XORed with that payload; a reader
+// that races a writer sees a key that does not match and treats the slot
+// as a miss, so torn entries are never used.
+class TranspositionTable {
+  public:
+    enum Bound { NONE = 0, UPPER = 1, LOWER = 2, EXACT = 3 };
+
+    explicit TranspositionTable(int megabytes = 16) { resize(megabytes); }
+
+    // Size is rounded down to a power-of-two number of buckets
+    void resize(int megabytes) {
+        size_t bytes   = static_cast<size_t>(megabytes > 0 ? megabytes : 1) << 20;
+        size_t buckets = 1;
+        while (buckets * 2 * sizeof(Bucket) <= bytes) buckets *= 2;
+        m_buckets.reset(new Bucket[buckets]);
+        m_count = buckets;
+        m_mask  = buckets - 1;
+        clear();
+    }
+
+    // Not safe to call while a search is running
+    void clear() {
+        for (size_t i = 0; i < m_count; i++)
+            for (Slot& sl : m_buckets[i].slots) {
+                sl.keyXor.store(0, std::memory_order_relaxed);
+                sl.data.store(0, std::memory_order_relaxed);
+            }
+        m_generation = 0;
+    }
+
+    // Called once per chooseMove so older entries lose replacement priority
+    void newSearch() { m_generation = (m_generation + 1) & 63; }
+
+    bool probe(uint64_t key, TTEntry& out) const {
+        const Bucket& b = m_buckets[key & m_mask];
+        for (const Slot& sl : b.slots) {
+            uint64_t data = sl.data.load(std::memory_order_relaxed);
+            if ((sl.keyXor.load(std::memory_order_relaxed) ^ data) == key) {
+                out = unpack(key, data);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void store(uint64_t key, int depth, Bound bound, int score, int move) {
+        Bucket& b = m_buckets[key & m_mask];
+        Slot* victim = &b.slots[0];
+        int victimValue = 1 << 30;
+        for (Slot& sl : b.slots) {
+            uint64_t data = sl.data.load(std::memory_order_relaxed);
+            uint64_t k    = sl.keyXor.load(std::memory_order_relaxed) ^ data;
+            TTEntry e     = unpack(k, data);
+            if (k == key || k == 0) {
+                // Keep a deeper result for the same position from this search
+                if (k == key && e.depth > depth && bound != EXACT
+                    && (e.genBound >> 2) == m_generation)
+                    return;
+                victim = &sl;
+                break;
+            }
+            int age   = (m_generation - (e.genBound >> 2)) & 63;
+            int value = e.depth - 8 * age;
+            if (value < victimValue) { victimValue = value; victim = &sl; }
+        }
+        uint64_t data = uint64_t(uint32_t(score))
+                      | uint64_t(uint16_t(move)) << 32
+                      | uint64_t(depth < 255 ? depth : 255) << 48
+                      | uint64_t(m_generation << 2 | bound) << 56;
+        victim->data.store(data, std::memory_order_relaxed);
+        victim->keyXor.store(key ^ data, std::memory_order_relaxed);
+    }
+
+    static Bound boundOf(const TTEntry& e) { return Bound(e.genBound & 3); }
+
+    size_t sizeBytes() const { return m_count * sizeof(Bucket); }
+
+  private:
+    struct Slot {
+        std::atomic<uint64_t> keyXor{0};
+        std::atomic<uint64_t> data{0};
+    };
+    struct alignas(64) Bucket {
+        Slot slots[4];
+    };
+
+    static TTEntry unpack(uint64_t key, uint64_t data) {
+        TTEntry e;
+        e.key      = key;
+        e.score    = int32_t(uint32_t(data));
+        e.move     = uint16_t(data >> 32);
+        e.depth    = uint8_t(data >> 48);
+        e.genBound = uint8_t(data >> 56);
+        return e;
+    }
+
+    std::unique_ptr<Bucket[]> m_buckets;
+    size_t                    m_count = 0;
+    size_t                    m_mask = 0;
+    int                       m_generation = 0;
+};
+
+#endif // TRANSTABLE_H
@@ -1,7 +1,13 @@
 // main.cpp
 
 #include "GameCore.h"
+#include "EvalKernel.h"
+#include "GameRecord.h"
+#include "AnalysisServer.h"
+#include "Scheduler.h"
+#include <cstdio>
 #include <string>
+#include <vector>
 #include <iostream>
 #include <cassert>
 using namespace std;
@@ -38,6 +44,7 @@ void doPlayerTests()
         s.undoMove();
         assert(s.checkerAt(1, 2) == VACANT);
         assert(s.numberEmpty() == 5);
+        s.makeMove(1, BLACK);  // column 1 full again: only 2 and 3 are legal
 	cout << "=========" << endl;
 	int n = hp.chooseMove(s, 3, RED);
 	cout << "=========" << endl;
@@ -46,10 +53,464 @@ void doPlayerTests()
 	assert(n == 2 || n == 3);
 	n = sp.chooseMove(s, 3, RED);
 	assert(n == 2 || n == 3);
+
+	// PVS with aspiration windows finds what full-window alpha-beta does
+	Scaffold mid(7, 6);
+	const int opening[] = { 4, 4, 4, 3, 3, 5 };
+	for (int i = 0; i < 6; i++)
+		mid.makeMove(opening[i], i % 2 ? BLACK : RED);
+	SearchConfig ab;
+	ab.maxDepth = 9;
+	ab.moveTimeMs = 3600 * 1000;
+	ab.pvs = false;
+	ab.aspiration = 0;
+	SearchConfig pvs = ab;
+	pvs.pvs = true;
+	pvs.aspiration = 25;
+	SmartPlayer abPlayer("ab", ab), pvsPlayer("pvs", pvs);
+	abPlayer.chooseMove(mid, 4, RED);
+	pvsPlayer.chooseMove(mid, 4, RED);
+	assert(abPlayer.lastSearch().score == pvsPlayer.lastSearch().score);
+	assert(abPlayer.lastSearch().depth == 9 && pvsPlayer.lastSearch().depth == 9);
+
+	// The exact solver takes boards with more than 16 open columns
+	Scaffold wide(20, 2);
+	int color = RED;
+	for (int c = 1; c <= 22; c++, color = (color == RED ? BLACK : RED))
+		wide.makeMove(c <= 20 ? c : c - 20, color);  // no three in a row
+	SearchConfig exact;
+	exact.moveTimeMs = 0;
+	SmartPlayer solver("Bart", exact);
+	n = solver.chooseMove(wide, 3, color);
+	assert(solver.lastSearch().solved && n >= 3 && n <= 20);
+}
+
+// Copies share storage until one of them moves; neither then sees the
+// other's moves, on small and on large boards
+void doScaffoldTests()
+{
+	const int boards[][2] = { {7, 6}, {1000, 1000} };
+	for (const auto& b : boards)
+	{
+		Scaffold s(b[0], b[1], 4);
+		for (int i = 0; i < 3; i++)
+			s.makeMove(b[0] / 2 + i, i % 2 ? BLACK : RED);
+		Scaffold snap = s;
+		Scaffold other(2, 2);
+		other = s;
+		s.makeMove(1, BLACK);
+		assert(s.checkerAt(1, 1) == BLACK && snap.checkerAt(1, 1) == VACANT);
+		assert(snap.numberEmpty() == s.numberEmpty() + 1);
+		other.makeMove(b[0], RED);
+		other.undoMove();
+		other.undoMove();
+		assert(other.checkerAt(b[0] / 2 + 2, 1) == VACANT);
+		assert(snap.checkerAt(b[0] / 2 + 2, 1) == RED && s.checkerAt(b[0] / 2 + 2, 1) == RED);
+		assert(snap.hash() != s.hash() && other.hash() != snap.hash());
+		snap.makeMove(1, BLACK);
+		assert(snap.hash() == s.hash() && snap.state() == PLAYING);
+	}
+
+	// A position and its mirror image share a canonical hash
+	Scaffold left(7, 6), right(7, 6);
+	assert(left.symmetric());
+	left.makeMove(2, RED);
+	left.makeMove(4, BLACK);
+	right.makeMove(6, RED);
+	right.makeMove(4, BLACK);
+	assert(!left.symmetric() && left.hash() != right.hash());
+	assert(left.mirrorHash() == right.hash() && left.canonicalHash() == right.canonicalHash());
+	left.makeMove(6, RED);
+	assert(left.symmetric());
+	left.undoMove();
+	assert(left.mirrorHash() == right.hash());
+}
+
+// The bulk evaluation kernel must agree exactly with the window-by-window
+// heuristic, for every instruction set this CPU runs, on random positions;
+// so must the incremental EvalState under other weights, which also survive
+// a trip through a weights file
+void doEvalKernelTests()
+{
+	EvalParams tuned;
+	tuned.square = 13;
+	tuned.linear = 5;
+	tuned.empty = 11;
+	tuned.threat = 40;
+	tuned.tempo = 7;
+	const char* path = "evalparams_test.txt";
+	EvalParams loaded;
+	assert(tuned.save(path) && loaded.load(path) && loaded == tuned);
+	remove(path);
+	const int boards[][3] = { {7, 6, 4}, {9, 7, 5}, {19, 19, 5}, {3, 2, 3},
+	                          {40, 3, 4}, {5, 20, 3}, {64, 1, 2} };
+	unsigned rng = 12345;
+	for (const auto& b : boards)
+	{
+		for (int game = 0; game < 40; game++)
+		{
+			Scaffold s(b[0], b[1]);
+			int color = RED;
+			int moves = (rng = rng * 1103515245 + 12345) % (b[0] * b[1] + 1);
+			for (int i = 0; i < moves; i++)
+			{
+				int col = (rng = rng * 1103515245 + 12345) / 65536 % b[0] + 1;
+				if (s.makeMove(col, color))
+					color = (color == RED ? BLACK : RED);
+			}
+			int red = SmartPlayer::heuristicScoreScalar(s, b[2], RED);
+			int black = SmartPlayer::heuristicScoreScalar(s, b[2], BLACK);
+			for (int isa = EvalKernel::SCALAR; isa <= EvalKernel::AVX2; isa++)
+			{
+				if (!EvalKernel::supported(EvalKernel::Isa(isa)))
+					continue;
+				assert(EvalKernel::score(s, b[2], RED, EvalKernel::Isa(isa)) == red);
+				assert(EvalKernel::score(s, b[2], BLACK, EvalKernel::Isa(isa)) == black);
+			}
+			assert(SmartPlayer::heuristicScore(s, b[2], RED) == red);
+
+			EvalState e;
+			e.reset(b[0], b[1], b[2], tuned);
+			for (int c = 1; c <= b[0]; c++)
+				for (int r = 1; r <= b[1] && s.checkerAt(c, r) != VACANT; r++)
+					e.play(c, s.checkerAt(c, r));
+			assert(SmartPlayer::heuristicScoreScalar(s, b[2], BLACK, tuned) == e.score(BLACK));
+			assert(SmartPlayer::heuristicScore(s, b[2], BLACK, tuned) == e.score(BLACK));
+		}
+	}
+
+	// The compile-time sized engine weighs windows the same way
+	SearchConfig cfg;
+	cfg.eval = tuned;
+	cfg.maxDepth = 7;
+	cfg.moveTimeMs = 3600 * 1000;
+	SmartPlayer fixed("fixed", cfg);
+	cfg.fixedEngine = false;
+	SmartPlayer generic("generic", cfg);
+	Scaffold s(7, 6, 4);
+	fixed.chooseMove(s, 4, RED);
+	generic.chooseMove(s, 4, RED);
+	assert(fixed.lastSearch().nodes == generic.lastSearch().nodes);
+	assert(fixed.lastSearch().score == generic.lastSearch().score);
+}
+
+// A network's incrementally kept accumulators match ones built from scratch
+// for the same position, every instruction set scores them alike, and the
+// weights come back unchanged from a network file
+void doNnueTests()
+{
+	NnueNetwork net(7, 6, 4);
+	unsigned rng = 4321;
+	auto next = [&rng](int range) { rng = rng * 1103515245 + 12345; return int(rng / 65536 % range) - range / 2; };
+	for (auto& r : net.w1)
+		for (auto& w : r)
+			w = int16_t(next(120));
+	for (auto& w : net.b1) w = int16_t(next(200));
+	for (auto& w : net.w2) w = int8_t(next(255));
+	for (auto& w : net.b2) w = next(20000);
+	for (auto& w : net.w3) w = int16_t(next(400));
+	net.b3 = next(20000);
+	const char* path = "nnue_test.bin";
+	assert(net.save(path));
+	shared_ptr<const NnueNetwork> loaded = NnueNetwork::load(path);
+	assert(loaded && loaded->matches(7, 6, 4) && loaded->w1 == net.w1 && loaded->w2 == net.w2
+	       && loaded->b2 == net.b2 && loaded->w3 == net.w3 && loaded->b3 == net.b3);
+
+	for (int game = 0; game < 40; game++)
+	{
+		Scaffold s(7, 6);
+		NnueState inc;
+		inc.reset(&net);
+		vector<int> played;
+		int color = RED;
+		int moves = next(84) + 42;
+		for (int i = 0; i < moves; i++)
+		{
+			int col = next(7) + 4;
+			if (s.makeMove(col, color))
+			{
+				inc.play(col, color);
+				played.push_back(col);
+				color = (color == RED ? BLACK : RED);
+			}
+		}
+		for (int i = 0; i < 3 && !played.empty(); i++)
+		{
+			color = (color == RED ? BLACK : RED);
+			inc.undo(played.back(), color);
+			played.pop_back();
+			s.undoMove();
+		}
+		NnueState built;
+		built.reset(loaded.get());
+		for (int c = 1; c <= 7; c++)
+			for (int r = 1; r <= 6 && s.checkerAt(c, r) != VACANT; r++)
+				built.play(c, s.checkerAt(c, r));
+		assert(inc.score(RED) == built.score(RED));
+		assert(inc.score(BLACK) == built.score(BLACK));
+	}
+
+	for (int trial = 0; trial < 100; trial++)
+	{
+		int16_t a[NnueNetwork::HIDDEN], b[NnueNetwork::HIDDEN];
+		for (int i = 0; i < NnueNetwork::HIDDEN; i++)
+		{
+			a[i] = int16_t(next(400));
+			b[i] = int16_t(next(400));
+		}
+		int scalar = net.propagate(a, b, EvalKernel::SCALAR);
+		for (int isa = EvalKernel::SSE2; isa <= EvalKernel::AVX2; isa++)
+			if (EvalKernel::supported(EvalKernel::Isa(isa)))
+				assert(net.propagate(a, b, EvalKernel::Isa(isa)) == scalar);
+	}
+
+	// Both engines search the same tree with it
+	SearchConfig cfg;
+	cfg.nnuePath = path;
+	cfg.maxDepth = 7;
+	cfg.moveTimeMs = 3600 * 1000;
+	SmartPlayer fixed("fixed", cfg);
+	cfg.fixedEngine = false;
+	SmartPlayer generic("generic", cfg);
+	remove(path);
+	Scaffold s(7, 6, 4);
+	fixed.chooseMove(s, 4, RED);
+	generic.chooseMove(s, 4, RED);
+	assert(fixed.lastSearch().nodes == generic.lastSearch().nodes);
+	assert(fixed.lastSearch().score == generic.lastSearch().score);
+}
+
+// Time allotments stay within the clock, and a SmartPlayer on a short
+// clock answers within its hard deadline
+void doTimeControlTests()
+{
+	TimeControl tc;
+	double soft, hard;
+	tc.allocate(42, soft, hard);
+	assert(soft == 0 && hard == 0);
+	tc.moveTimeMs = 50;
+	tc.allocate(42, soft, hard);
+	assert(soft == 50 && hard == 50);
+	tc.moveTimeMs = 0;
+	for (int clock : {1, 30, 400, 60000})
+		for (int empty : {0, 1, 2, 42, 400})
+		{
+			tc.clockMs = clock;
+			tc.incrementMs = clock / 10;
+			tc.allocate(empty, soft, hard);
+			assert(soft > 0 && soft <= hard && hard <= max(1, clock));
+		}
+
+	SearchConfig cfg;
+	cfg.solverMaxEmpty = 0;
+	SmartPlayer sp("Bart", cfg);
+	tc.clockMs = 300;
+	tc.incrementMs = 0;
+	sp.setTimeControl(tc);
+	Scaffold s(7, 6, 4);
+	int n = sp.chooseMove(s, 4, RED);
+	assert(n >= 1 && n <= 7);
+	assert(sp.lastSearch().hardMs <= 300 && sp.lastSearch().ms < 300 + 50);
+}
+
+// Games written to a record file read back move for move, with the nibble
+// packing (odd and even move counts) and the varint moves of wide boards
+void doGameRecordTests()
+{
+	const char* path = "gamerecord_test.cng";
+	remove(path);
+	const int sizes[][3] = { {7, 6, 4}, {7, 6, 4}, {20, 4, 4} };
+	vector<vector<int>> games;
+	{
+		GameRecordWriter w;
+		assert(w.open(path));
+		GameRecord r;
+		unsigned rng = 777;
+		for (int g = 0; g < 3; g++)
+		{
+			Scaffold s(sizes[g][0], sizes[g][1], sizes[g][2]);
+			r.begin(sizes[g][0], sizes[g][1], sizes[g][2], "Lisa", g == 2 ? "" : "Maggie");
+			games.push_back({});
+			for (int color = RED; s.state() == PLAYING; color = (color == RED ? BLACK : RED))
+			{
+				int col;
+				do
+					col = (rng = rng * 1103515245 + 12345) / 65536 % s.cols() + 1;
+				while (!s.makeMove(col, color));
+				games.back().push_back(col);
+				r.addMove(col, g == 1 ? GameRecord::NO_SCORE : 50 - int(games.back().size()) * 7,
+				          g == 2 ? GameRecord::NO_TIME : col * 3);
+			}
+			if (g == 0 && games[0].size() % 2 == 0)
+			{
+				s.undoMove();  // keep one game with an odd number of moves
+				games[0].pop_back();
+				r.begin(7, 6, 4, "Lisa", "Maggie");
+				for (size_t i = 0; i < games[0].size(); i++)
+					r.addMove(games[0][i], 50 - int(i + 1) * 7, games[0][i] * 3);
+			}
+			r.finish(s.state(), g == 1);
+			assert(w.write(r));
+		}
+		assert(w.games() == 3);
+	}
+
+	GameRecordReader reader;
+	assert(reader.open(path));
+	GameView g;
+	for (int n = 0; n < 3; n++)
+	{
+		assert(reader.next(g));
+		assert(g.cols == sizes[n][0] && g.levels == sizes[n][1] && g.N == sizes[n][2]);
+		assert(g.red == "Lisa" && g.black == (n == 2 ? "" : "Maggie"));
+		assert(g.onTime == (n == 1) && g.numMoves == int(games[n].size()));
+		assert(g.hasScores == (n != 1) && g.hasTimes == (n != 2));
+		Scaffold s(g.cols, g.levels);
+		size_t i = 0;
+		bool ok = g.forEachPosition(s, [&](const Scaffold& b, int col, int color, int score, int ms)
+		{
+			assert(col == games[n][i] && color == (i % 2 ? BLACK : RED));
+			assert(score == (n == 1 ? GameRecord::NO_SCORE : 50 - int(i + 1) * 7));
+			assert(ms == (n == 2 ? GameRecord::NO_TIME : col * 3));
+			i++;
+			if (i == games[n].size())
+				assert(b.state() == g.result);
+		});
+		assert(ok && i == games[n].size() && s.numberEmpty() == g.cols * g.levels);
+	}
+	assert(!reader.next(g));
+	reader.close();
+	remove(path);
+
+	// Small negative scores take no more room than positive ones
+	GameRecord pos, neg;
+	pos.begin(7, 6, 4, "Lisa", "Maggie");
+	neg.begin(7, 6, 4, "Lisa", "Maggie");
+	for (int i = 1; i <= 30; i++)
+	{
+		pos.addMove(i % 7 + 1, i * 2, GameRecord::NO_TIME);
+		neg.addMove(i % 7 + 1, -i * 2, GameRecord::NO_TIME);
+	}
+	pos.finish(TIE, false);
+	neg.finish(TIE, false);
+	assert(neg.bytes().size() == pos.bytes().size());
+}
+
+// Requests are answered by id, a position asked twice in one batch is
+// searched once, and bad lines get an error instead of a search
+void doAnalysisServerTests()
+{
+	ServerConfig cfg;
+	cfg.workers = 1;
+	cfg.search.solverMaxEmpty = 0;
+	AnalysisServer server(cfg);
+	vector<string> replies;
+	AnalysisServer::Reply reply = [&](const string& line) { replies.push_back(line); };
+	assert(server.handle("analyze a 7x6x4 4453 depth 6", reply));
+	assert(server.handle("analyze b 7x6x4 4453 depth 6", reply));
+	assert(server.handle("analyze c 12x5x4 1,12,6 nodes 2000", reply));
+	assert(server.handle("analyze d 7x6x4 8", reply));
+	assert(server.handle("analyze e 7x6x4 1212121", reply));
+	assert(!server.handle("quit", reply));
+	server.wait();
+	assert(replies.size() == 5);
+	int answered = 0;
+	for (const string& r : replies)
+	{
+		if (r.compare(0, 9, "bestmove ") == 0)
+			answered++;
+		else
+			assert(r.compare(0, 8, "error d ") == 0 || r.compare(0, 8, "error e ") == 0);
+	}
+	ServerStats st = server.stats();
+	assert(answered == 3 && st.requests == 5 && st.errors == 2);
+	assert(st.searches >= 2 && st.searches <= 3 && st.p50 <= st.p99 && st.p99 <= st.maxMs);
+}
+
+// A search with no limits stops when its move is called off, and a pool
+// of two threads plays many games to the end
+void doSchedulerTests()
+{
+	WorkerPool pool(2);
+	SearchConfig cfg;
+	cfg.moveTimeMs = 0;
+	cfg.solverMaxEmpty = 0;
+	SmartPlayer sp("Homer", cfg);
+	Scaffold s(7, 6, 4);
+	CancelToken cancel;
+	future<int> move = sp.chooseMoveAsync(s, 4, RED, nullptr, cancel, pool);
+	assert(move.wait_for(chrono::milliseconds(50)) == future_status::timeout);
+	cancel.cancel();
+	assert(move.wait_for(chrono::seconds(10)) == future_status::ready);
+	int col = move.get();
+	assert(col >= 1 && col <= 7);
+
+	// So does an exact solve, and a move called off before it starts is none
+	cfg.solverMaxEmpty = 42;
+	SmartPlayer solver("Bart", cfg);
+	CancelToken solveCancel;
+	move = solver.chooseMoveAsync(s, 4, RED, nullptr, solveCancel, pool);
+	assert(move.wait_for(chrono::milliseconds(50)) == future_status::timeout);
+	solveCancel.cancel();
+	assert(move.wait_for(chrono::seconds(10)) == future_status::ready);
+	col = move.get();
+	assert(col >= 1 && col <= 7);
+	assert(solver.chooseMoveCancellable(s, 4, RED, nullptr, solveCancel) == 0);
+
+	// A player with no move to give (0) forfeits and the game ends:
+	// BadPlayer fills the bottom row, then has nothing for BLACK's fourth
+	BadPlayer red("Patty"), black("Selma");
+	Game game(7, 6, 4, &red, &black);
+	Game::Turn t;
+	int turns = 0;
+	for (; turns < 100 && game.nextTurn(t); turns++)
+		game.playTurn(t.player->chooseMove(*t.position, t.N, t.color), 0);
+	int winner;
+	assert(turns == 8 && game.completed(winner) && winner == RED);
+
+	// Opening moves are played for the side to move, off its player's choice
+	Game opened(7, 6, 4, &red, &black);
+	opened.playOpening(4);
+	opened.playOpening(4);
+	assert(opened.nextTurn(t) && t.color == RED && opened.checkerAt(4, 2) == BLACK);
+
+	SchedulerConfig sc;
+	sc.threads = 2;
+	sc.budget.nodes = 500;
+	vector<unique_ptr<Player>> players;
+	vector<unique_ptr<Game>> games;
+	for (int i = 0; i < 40; i++)
+	{
+		players.emplace_back(new BadPlayer("Patty"));
+		players.emplace_back(new SmartPlayer("Selma", cfg));
+		games.emplace_back(new Game(5, 4, 3, players[2 * i].get(), players[2 * i + 1].get()));
+	}
+	atomic<int> ended{0};
+	{
+		GameScheduler scheduler(sc);
+		for (auto& g : games)
+			scheduler.add(*g, [&](Game& game, int winner) {
+				int w;
+				assert(game.completed(w) && w == winner);
+				ended++;
+			});
+		scheduler.wait();
+		SchedulerStats st = scheduler.stats();
+		assert(st.games == 40 && st.finished == 40 && st.moves >= 40 * 5);
+		assert(st.p50 <= st.p99 && st.p99 <= st.maxMs && st.movesPerSec > 0);
+	}
+	assert(ended == 40);
 }
 
 int main()
 {
         doPlayerTests();
+        doScaffoldTests();
+        doEvalKernelTests();
+        doNnueTests();
+        doTimeControlTests();
+        doGameRecordTests();
+        doAnalysisServerTests();
+        doSchedulerTests();
         cout << "Passed all tests" << endl;
 }
@@ -0,0 +1,108 @@
+// tools/SelfPlay.h
+//
+// Self-play shared by the training tools (tools/tune.cpp, tools/nnue.cpp):
+// fixed-depth SmartPlayers play games from random openings, one game per
+// task on a WorkerPool, and the tool picks what it keeps from every
+// position through a callback.  Header-only, for the tools alone.
+#ifndef SELFPLAY_H
+#define SELFPLAY_H
+
+#include "GameCore.h"
+#include "Scheduler.h"
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+struct SelfPlayConfig {
+    int        cols = 7, levels = 6, N = 4;
+    int        depth        = 4;  // search depth of both players
+    int        openingPlies = 6;  // random moves before they take over
+    unsigned   seed         = 1;  // picks the openings
+    EvalParams eval;              // the players' evaluation weights
+};
+
+static bool winsAtOnce(Scaffold& s, int color) {
+    GameState win = (color == RED ? REDWIN : BLACKWIN);
+    for (int c = 1; c <= s.cols(); c++) {
+        if (!s.makeMove(c, color)) continue;
+        bool won = s.state() == win;
+        s.undoMove();
+        if (won) return true;
+    }
+    return false;
+}
+
+// One game in ten is held out to check a fit
+static bool heldOut(int game) { return game % 10 == 9; }
+
+// A finished game's result for `color`: 1, 1/2 or 0
+static double resultFor(GameState end, int color) {
+    GameState win = (color == RED ? REDWIN : BLACKWIN);
+    return end == TIE ? 0.5 : end == win ? 1.0 : 0.0;
+}
+
+// Plays the game that cfg.seed and `game` pick, through Game like any
+// other.  Every position after the opening where the side to move cannot
+// win at once goes to visit(position, color, player) after the player has
+// searched it, so player.lastSearch() describes that search.  Returns how
+// the game ended.
+template <class Visit>
+static GameState selfPlay(const SelfPlayConfig& cfg, int game, Visit visit) {
+    SearchConfig sc;
+    sc.maxDepth       = cfg.depth;
+    sc.moveTimeMs     = 3600 * 1000;
+    sc.hashMB         = 1;
+    sc.solverMaxEmpty = 0;
+    sc.eval           = cfg.eval;
+    SmartPlayer sp("selfplay", sc);
+    Game g(cfg.cols, cfg.levels, cfg.N, &sp, &sp);
+
+    std::mt19937 rng(cfg.seed * 7919u + game);
+    Game::Turn t;
+    for (int i = 0; i < cfg.openingPlies && g.nextTurn(t);) {
+        int c = 1 + static_cast<int>(rng() % cfg.cols);
+        if (g.checkerAt(c, cfg.levels) != VACANT) continue;  // full
+        g.playOpening(c);
+        i++;
+    }
+    while (g.nextTurn(t)) {
+        Scaffold pos = *t.position;
+        bool keep = !winsAtOnce(pos, t.color);
+        int col = sp.chooseMove(pos, t.N, t.color);
+        if (keep) visit(pos, t.color, sp);
+        g.playTurn(col, 0);
+    }
+    int winner = VACANT;
+    g.completed(winner);
+    return winner == RED ? REDWIN : winner == BLACK ? BLACKWIN : TIE;
+}
+
+// Runs play(game) for `games` games on a pool of `threads` and joins what
+// they return, in game order
+template <class Sample, class Play>
+static std::vector<Sample> playGames(int games, int threads, Play play) {
+    std::vector<std::vector<Sample>> perGame(games);
+    {
+        WorkerPool pool(threads);
+        for (int g = 0; g < games; g++)
+            pool.post([&perGame, &play, g] { perGame[g] = play(g); });
+    }
+    std::vector<Sample> all;
+    for (auto& v : perGame)
+        for (Sample& x : v) all.push_back(std::move(x));
+    return all;
+}
+
+// Runs f(begin, end, slot) over `threads` slices of [0, n) at once
+template <class F>
+static void parallelFor(size_t n, int threads, F f) {
+    std::vector<std::thread> pool;
+    size_t step = (n + threads - 1) / threads;
+    for (int i = 1; i < threads; i++)
+        pool.emplace_back(f, std::min(n, i * step), std::min(n, (i + 1) * step), i);
+    f(0, std::min(n, step), 0);
+    for (std::thread& t : pool) t.join();
+}
+
+#endif // SELFPLAY_H
@@ -0,0 +1,107 @@
+// tools/arena.cpp
+//
+// Headless match between two bots, e.g. to regression-test SmartPlayer
+// changes.  Built by the top-level CMakeLists.txt (target `arena`), e.g.
+//
+//   cmake -S . -B build && cmake --build build --target arena
+//   ./arena smart mcts --games 2000 --board 7x6x4 --movetime 20
+//
+// Players: smart, smart-ponder (thinks on the opponent's time about its
+// expected reply), smart-ponder-all (about every reply), smart-ab (plain
+// full-window alpha-beta instead of PVS with aspiration windows), mcts, bad.
+// Options:
+//   --games n        number of games (default 1000, rounded up to pairs)
+//   --board CxLxN    columns x levels x win length (default 7x6x4)
+//   --threads n      parallel games (default: hardware threads)
+//   --movetime ms    per-move time budget (default 100, 0 = none)
+//   --nodes n        per-move node/playout budget (default 0 = none)
+//   --opening n      random opening plies (default 2)
+//   --seed n         opening seed (default 1)
+//   --record file    append every game to a game record file (see
+//                    GameRecord.h and tools/records.cpp)
+
+#include "Arena.h"
+#include "GameRecord.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+static PlayerFactory makeFactory(const string& type) {
+    if (type == "smart")
+        return [] { return unique_ptr<Player>(new SmartPlayer("smart")); };
+    if (type == "smart-ponder" || type == "smart-ponder-all") {
+        SearchConfig cfg;
+        cfg.ponder = type == "smart-ponder" ? SearchConfig::PONDER_PREDICTED
+                                            : SearchConfig::PONDER_ALL;
+        return [type, cfg] { return unique_ptr<Player>(new SmartPlayer(type, cfg)); };
+    }
+    if (type == "smart-ab") {
+        SearchConfig cfg;
+        cfg.pvs        = false;
+        cfg.aspiration = 0;
+        return [cfg] { return unique_ptr<Player>(new SmartPlayer("smart-ab", cfg)); };
+    }
+    if (type == "mcts")
+        return [] { return unique_ptr<Player>(new MCTSPlayer("mcts")); };
+    if (type == "bad")
+        return [] { return unique_ptr<Player>(new BadPlayer("bad")); };
+    return PlayerFactory();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "usage: arena <playerA> <playerB> [options]\n";
+        return 2;
+    }
+    PlayerFactory a = makeFactory(argv[1]), b = makeFactory(argv[2]);
+    if (!a || !b) {
+        cerr << "unknown player type (smart, smart-ponder, smart-ponder-all, smart-ab, mcts, bad)\n";
+        return 2;
+    }
+
+    ArenaConfig cfg;
+    GameRecordWriter recorder;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        const char* opt = argv[i];
+        const char* val = argv[i + 1];
+        if      (!strcmp(opt, "--games"))    cfg.games        = atoi(val);
+        else if (!strcmp(opt, "--threads"))  cfg.threads      = atoi(val);
+        else if (!strcmp(opt, "--movetime")) cfg.moveTimeMs   = atoi(val);
+        else if (!strcmp(opt, "--nodes"))    cfg.moveNodes    = atoll(val);
+        else if (!strcmp(opt, "--opening"))  cfg.openingPlies = atoi(val);
+        else if (!strcmp(opt, "--seed"))     cfg.seed         = strtoul(val, nullptr, 10);
+        else if (!strcmp(opt, "--record")) {
+            if (!recorder.open(val)) {
+                cerr << "cannot append games to " << val << "\n";
+                return 2;
+            }
+            cfg.recorder = &recorder;
+        }
+        else if (!strcmp(opt, "--board"))
+            sscanf(val, "%dx%dx%d", &cfg.cols, &cfg.levels, &cfg.N);
+        else {
+            cerr << "unknown option " << opt << "\n";
+            return 2;
+        }
+    }
+    cfg.games += cfg.games % 2;
+
+    ArenaResult r = runArena(cfg, a, b, [](const ArenaResult& p) {
+        fprintf(stderr, "\r+%d =%d -%d  elo %+.1f +/- %.1f   ",
+                p.wins, p.draws, p.losses, p.elo, p.eloError);
+    });
+    fprintf(stderr, "\n");
+    printf("%s vs %s on %dx%d N=%d: %d games\n", argv[1], argv[2],
+           cfg.cols, cfg.levels, cfg.N, r.wins + r.draws + r.losses);
+    printf("W/D/L %d/%d/%d  score %.1f%%\n", r.wins, r.draws, r.losses,
+           100 * r.score);
+    printf("elo %+.1f +/- %.1f (95%%)  games/sec %.2f\n",
+           r.elo, r.eloError, r.gamesPerSec);
+    if (cfg.recorder)
+        printf("recorded %lld games\n", recorder.games());
+    return 0;
+}
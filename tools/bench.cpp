@@ -0,0 +1,307 @@
+// tools/bench.cpp
+//
+// Micro and search benchmarks.  Every measurement is printed as one JSON
+// object per line so results can be collected and compared across commits.
+// Built by the top-level CMakeLists.txt (target `bench`):
+//
+//   cmake -S . -B build && cmake --build build --target bench
+//   ./bench [--quick] [--tag <commit>] > bench.jsonl
+
+#include "GameCore.h"
+#include "FixedScaffold.h"
+#include "EvalKernel.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct BenchPosition {
+    const char* name;
+    int cols, levels, N, depth, quickDepth;
+    vector<int> moves;  // columns played so far, RED first
+};
+
+static vector<BenchPosition> positions() {
+    return {
+        { "7x6x4-empty",   7,  6,  4, 14, 10, {} },
+        { "7x6x4-mid",     7,  6,  4, 16, 12, {4, 4, 4, 3, 3, 5, 5, 2} },
+        { "9x7x5-empty",   9,  7,  5, 12,  7, {} },
+        { "9x7x5-mid",     9,  7,  5, 12,  8, {5, 5, 4, 6, 6, 4, 3, 7} },
+        { "19x19x5-empty", 19, 19, 5,  6,  4, {} },
+        { "19x19x5-mid",   19, 19, 5,  6,  4, {10, 10, 9, 11, 11, 9, 12, 8} },
+    };
+}
+
+static string g_tag;
+
+static void emit(const string& bench, const string& board, const string& fields) {
+    cout << "{\"bench\":\"" << bench << "\",\"board\":\"" << board << "\"";
+    if (!g_tag.empty()) cout << ",\"tag\":\"" << g_tag << "\"";
+    cout << "," << fields << "}" << endl;
+}
+
+static double secondsSince(chrono::steady_clock::time_point t) {
+    return chrono::duration<double>(chrono::steady_clock::now() - t).count();
+}
+
+static Scaffold setUp(const BenchPosition& p) {
+    Scaffold s(p.cols, p.levels, p.N);
+    int color = RED;
+    for (int c : p.moves) {
+        s.makeMove(c, color);
+        color = (color == RED ? BLACK : RED);
+    }
+    return s;
+}
+
+// Replays a fixed list of moves so a Game can be driven to a position
+class ScriptedPlayer : public Player {
+  public:
+    ScriptedPlayer(const vector<int>& moves, int parity)
+      : Player("script"), m_moves(moves), m_next(parity) {}
+    int chooseMove(const Scaffold&, int, int) override {
+        int c = m_moves[m_next];
+        m_next += 2;
+        return c;
+    }
+    bool isInteractive() const override { return false; }
+  private:
+    vector<int> m_moves;
+    size_t      m_next;
+};
+
+static volatile long long g_sink;  // keeps measured results alive
+
+static void benchMakeUndo(const BenchPosition& p, long iters) {
+    Scaffold s = setUp(p);
+    auto t = chrono::steady_clock::now();
+    long ops = 0;
+    for (long i = 0; i < iters; i++) {
+        for (int c = 1; c <= s.cols(); c++) {
+            if (!s.makeMove(c, (i + c) % 2 ? RED : BLACK)) continue;
+            g_sink += s.state();
+            s.undoMove();
+            ops++;
+        }
+    }
+    double sec = secondsSince(t);
+    ostringstream f;
+    f << "\"ns_per_op\":" << sec * 1e9 / ops << ",\"ops\":" << ops;
+    emit("scaffold.make_undo", p.name, f.str());
+}
+
+// Snapshots of a 1000x1000 board with 20000 checkers: a copy that is only
+// read, and a copy that then moves (and so takes its own storage)
+static void benchSnapshot(long iters) {
+    Scaffold s(1000, 1000, 5);
+    unsigned rng = 1;
+    for (int i = 0; i < 20000; i++) {
+        rng = rng * 1103515245 + 12345;
+        s.makeMove(rng / 65536 % 1000 + 1, i % 2 ? BLACK : RED);
+    }
+    auto t = chrono::steady_clock::now();
+    for (long i = 0; i < iters; i++) {
+        Scaffold c = s;
+        g_sink += c.numberEmpty();
+    }
+    double copy = secondsSince(t) * 1e9 / iters;
+    t = chrono::steady_clock::now();
+    for (long i = 0; i < iters; i++) {
+        Scaffold c = s;
+        c.makeMove(500, RED);
+        g_sink += c.numberEmpty();
+    }
+    double copyMove = secondsSince(t) * 1e9 / iters;
+    ostringstream f;
+    f << "\"copy_ns\":" << copy << ",\"copy_and_move_ns\":" << copyMove
+      << ",\"mask_bytes\":" << 2 * 8 * s.maskWords();
+    emit("scaffold.snapshot", "1000x1000x5", f.str());
+}
+
+static void benchCompleted(const BenchPosition& p, long iters) {
+    ScriptedPlayer red(p.moves, 0), black(p.moves, 1);
+    Game g(p.cols, p.levels, p.N, &red, &black);
+    streambuf* old = cout.rdbuf(nullptr);  // takeTurn announces every move
+    for (size_t i = 0; i < p.moves.size(); i++) g.takeTurn();
+    cout.rdbuf(old);
+
+    auto t = chrono::steady_clock::now();
+    for (long i = 0; i < iters; i++) {
+        int winner = 0;
+        g_sink += g.completed(winner) + winner;
+    }
+    ostringstream f;
+    f << "\"ns_per_call\":" << secondsSince(t) * 1e9 / iters;
+    emit("game.completed", p.name, f.str());
+}
+
+static void benchCheckState(const BenchPosition& p, long iters) {
+    Scaffold tracked = setUp(p);
+    Scaffold untracked = tracked;
+    untracked.setConnectN(0);  // forces the full-board scan
+
+    auto t = chrono::steady_clock::now();
+    for (long i = 0; i < iters; i++) g_sink += SmartPlayer::checkState(tracked, p.N);
+    double cached = secondsSince(t) * 1e9 / iters;
+
+    long scanIters = max(1L, iters / 100);
+    t = chrono::steady_clock::now();
+    for (long i = 0; i < scanIters; i++) g_sink += SmartPlayer::checkState(untracked, p.N);
+    double scan = secondsSince(t) * 1e9 / scanIters;
+
+    ostringstream f;
+    f << "\"ns_per_call\":" << cached << ",\"scan_ns_per_call\":" << scan;
+    emit("smart.check_state", p.name, f.str());
+}
+
+static void benchHeuristic(const BenchPosition& p, long iters) {
+    Scaffold s = setUp(p);
+    iters = max(1L, iters / (p.cols * p.levels));
+    auto t = chrono::steady_clock::now();
+    for (long i = 0; i < iters; i++) g_sink += SmartPlayer::heuristicScore(s, p.N, RED);
+    double full = secondsSince(t) * 1e9 / iters;
+
+    long scalarIters = max(1L, iters / 10);
+    t = chrono::steady_clock::now();
+    for (long i = 0; i < scalarIters; i++)
+        g_sink += SmartPlayer::heuristicScoreScalar(s, p.N, RED);
+    double scalar = secondsSince(t) * 1e9 / scalarIters;
+
+    // The incremental evaluator: one play/undo pair plus a read
+    EvalState e;
+    e.reset(p.cols, p.levels, p.N);
+    for (int c = 1; c <= s.cols(); c++)
+        for (int r = 1; r <= s.levels() && s.checkerAt(c, r) != VACANT; r++)
+            e.play(c, s.checkerAt(c, r));
+    long incIters = iters * 100;
+    int c = (p.cols + 1) / 2;
+    t = chrono::steady_clock::now();
+    for (long i = 0; i < incIters; i++) {
+        e.play(c, RED);
+        g_sink += e.score(RED);
+        e.undo(c, RED);
+    }
+    double inc = secondsSince(t) * 1e9 / incIters;
+
+    ostringstream f;
+    f << "\"ns_per_call\":" << full << ",\"isa\":\"" << EvalKernel::name(EvalKernel::detect())
+      << "\",\"scalar_ns_per_call\":" << scalar
+      << ",\"incremental_ns_per_update\":" << inc;
+    emit("smart.heuristic_score", p.name, f.str());
+}
+
+static SearchInfo benchSearch(const BenchPosition& p, int depth, bool fixedEngine,
+                              bool threats = true, bool symmetry = true,
+                              bool pvs = true) {
+    Scaffold s = setUp(p);
+    SearchConfig cfg;
+    cfg.maxDepth    = depth;
+    cfg.hashMB      = 64;
+    cfg.moveTimeMs  = 3600 * 1000;
+    cfg.fixedEngine = fixedEngine;
+    cfg.threats     = threats;
+    cfg.symmetry    = symmetry;
+    cfg.pvs         = pvs;
+    if (!pvs) cfg.aspiration = 0;
+    SmartPlayer sp("bench", cfg);
+    sp.chooseMove(s, p.N, p.moves.size() % 2 ? BLACK : RED);
+    const SearchInfo& info = sp.lastSearch();
+    ostringstream f;
+    f << "\"engine\":\"" << (fixedEngine ? "fixed" : "generic") << "\""
+      << ",\"threats\":" << (threats ? "true" : "false")
+      << ",\"symmetry\":" << (symmetry ? "true" : "false")
+      << ",\"pvs\":" << (pvs ? "true" : "false")
+      << ",\"depth\":" << info.depth << ",\"nodes\":" << info.nodes
+      << ",\"ms\":" << info.ms
+      << ",\"nps\":" << info.nps
+      << ",\"beta_cutoffs\":" << info.betaCutoffs
+      << ",\"first_move_cutoffs\":" << info.firstMoveCutoffs
+      << ",\"tt_hits\":" << info.ttHits
+      << ",\"move\":" << info.move << ",\"score\":" << info.score;
+    emit("smart.search", p.name, f.str());
+    return info;
+}
+
+// The compile-time sized engine against the generic one on the same search;
+// both walk the same tree, so equal node counts double as a check
+static void benchFixedSpeedup(const BenchPosition& p, int depth) {
+    if (!withFixedScaffold(p.cols, p.levels, p.N, [](auto*) {})) return;
+    SearchInfo generic = benchSearch(p, depth, false);
+    SearchInfo fixed   = benchSearch(p, depth, true);
+    ostringstream f;
+    f << "\"speedup\":" << (fixed.ms > 0 ? generic.ms / fixed.ms : 0)
+      << ",\"same_tree\":" << (generic.nodes == fixed.nodes && generic.move == fixed.move
+                                && generic.score == fixed.score ? "true" : "false");
+    emit("smart.fixed_speedup", p.name, f.str());
+}
+
+// Nodes searched to the same depth with and without threat analysis
+static void benchThreatReduction(const BenchPosition& p, int depth) {
+    SearchInfo plain   = benchSearch(p, depth, true, false);
+    SearchInfo threats = benchSearch(p, depth, true, true);
+    ostringstream f;
+    f << "\"nodes_plain\":" << plain.nodes << ",\"nodes_threats\":" << threats.nodes
+      << ",\"node_reduction\":" << (threats.nodes > 0 ? double(plain.nodes) / threats.nodes : 0)
+      << ",\"speedup\":" << (threats.ms > 0 ? plain.ms / threats.ms : 0)
+      << ",\"same_move\":" << (plain.move == threats.move ? "true" : "false");
+    emit("smart.threat_reduction", p.name, f.str());
+}
+
+// Nodes searched to the same depth with and without mirror symmetry
+static void benchSymmetryReduction(const BenchPosition& p, int depth) {
+    SearchInfo plain    = benchSearch(p, depth, true, true, false);
+    SearchInfo symmetry = benchSearch(p, depth, true, true, true);
+    ostringstream f;
+    f << "\"nodes_plain\":" << plain.nodes << ",\"nodes_symmetry\":" << symmetry.nodes
+      << ",\"node_reduction\":" << (symmetry.nodes > 0 ? double(plain.nodes) / symmetry.nodes : 0)
+      << ",\"speedup\":" << (symmetry.ms > 0 ? plain.ms / symmetry.ms : 0)
+      << ",\"same_move\":" << (plain.move == symmetry.move ? "true" : "false");
+    emit("smart.symmetry_reduction", p.name, f.str());
+}
+
+// Full-window alpha-beta against PVS with aspiration windows: nodes and
+// time to reach the same depth
+static void benchPvsReduction(const BenchPosition& p, int depth) {
+    SearchInfo plain = benchSearch(p, depth, true, true, true, false);
+    SearchInfo pvs   = benchSearch(p, depth, true, true, true, true);
+    ostringstream f;
+    f << "\"nodes_alphabeta\":" << plain.nodes << ",\"nodes_pvs\":" << pvs.nodes
+      << ",\"node_reduction\":" << (pvs.nodes > 0 ? double(plain.nodes) / pvs.nodes : 0)
+      << ",\"speedup\":" << (pvs.ms > 0 ? plain.ms / pvs.ms : 0)
+      << ",\"same_move\":" << (plain.move == pvs.move ? "true" : "false")
+      << ",\"same_score\":" << (plain.score == pvs.score ? "true" : "false");
+    emit("smart.pvs_reduction", p.name, f.str());
+}
+
+int main(int argc, char* argv[]) {
+    bool quick = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--quick")) quick = true;
+        else if (!strcmp(argv[i], "--tag") && i + 1 < argc) g_tag = argv[++i];
+    }
+    long iters = quick ? 20000 : 200000;
+
+    for (const BenchPosition& p : positions()) {
+        benchMakeUndo(p, iters);
+        benchCompleted(p, iters * 10);
+        benchCheckState(p, iters * 10);
+        benchHeuristic(p, iters);
+    }
+    benchSnapshot(iters / 100);
+    for (const BenchPosition& p : positions())
+        benchSearch(p, quick ? p.quickDepth : p.depth, true);
+    for (const BenchPosition& p : positions())
+        benchFixedSpeedup(p, quick ? p.quickDepth : p.depth);
+    for (const BenchPosition& p : positions())
+        benchThreatReduction(p, quick ? p.quickDepth : p.depth);
+    for (const BenchPosition& p : positions())
+        benchSymmetryReduction(p, quick ? p.quickDepth : p.depth);
+    for (const BenchPosition& p : positions())
+        benchPvsReduction(p, quick ? p.quickDepth : p.depth);
+    return 0;
+}
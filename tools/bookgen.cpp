@@ -0,0 +1,129 @@
+// tools/bookgen.cpp
+//
+// Offline opening book generator: deep-searches every position up to a
+// given ply and writes the results as a sorted book that SmartPlayer maps
+// at startup (SearchConfig::bookPath).  Built by the top-level
+// CMakeLists.txt (target `bookgen`), e.g.
+//
+//   cmake -S . -B build && cmake --build build --target bookgen
+//   ./bookgen --board 7x6x4 --plies 4 --depth 14 --out 7x6x4.book
+//
+// Options:
+//   --board CxLxN    board and win length (default 7x6x4)
+//   --plies n        book covers positions with up to n checkers (default 4)
+//   --depth n        search depth per position (default 14)
+//   --movetime ms    time cap per position (default 60000)
+//   --threads n      positions searched in parallel (default: hardware)
+//   --hash mb        table size per worker (default 64)
+//   --out file       output path (default <C>x<L>x<N>.book)
+
+#include "GameCore.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+struct BookJob {
+    vector<int> moves;
+    int         color;
+};
+
+// Every distinct non-terminal position with at most `plies` checkers, a
+// position and its mirror image counted once
+static void enumerate(Scaffold& s, int color, int plies, vector<int>& moves,
+                      unordered_set<uint64_t>& seen, vector<BookJob>& out) {
+    if (s.state() != PLAYING) return;
+    if (!seen.insert(SmartPlayer::bookKey(s, color)).second) return;
+    out.push_back({moves, color});
+    if (static_cast<int>(moves.size()) == plies) return;
+    for (int c = 1; c <= s.cols(); c++) {
+        if (!s.makeMove(c, color)) continue;
+        moves.push_back(c);
+        enumerate(s, color == RED ? BLACK : RED, plies, moves, seen, out);
+        moves.pop_back();
+        s.undoMove();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int cols = 7, levels = 6, N = 4, plies = 4, depth = 14, moveTimeMs = 60000;
+    int threads = max(1u, thread::hardware_concurrency()), hashMB = 64;
+    string out;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* opt = argv[i];
+        const char* val = argv[i + 1];
+        if      (!strcmp(opt, "--board"))    sscanf(val, "%dx%dx%d", &cols, &levels, &N);
+        else if (!strcmp(opt, "--plies"))    plies      = atoi(val);
+        else if (!strcmp(opt, "--depth"))    depth      = atoi(val);
+        else if (!strcmp(opt, "--movetime")) moveTimeMs = atoi(val);
+        else if (!strcmp(opt, "--threads"))  threads    = atoi(val);
+        else if (!strcmp(opt, "--hash"))     hashMB     = atoi(val);
+        else if (!strcmp(opt, "--out"))      out        = val;
+        else {
+            cerr << "unknown option " << opt << "\n";
+            return 2;
+        }
+    }
+    if (out.empty())
+        out = to_string(cols) + "x" + to_string(levels) + "x" + to_string(N) + ".book";
+
+    Scaffold root(cols, levels, N);
+    vector<int> moves;
+    unordered_set<uint64_t> seen;
+    vector<BookJob> jobs;
+    enumerate(root, RED, plies, moves, seen, jobs);
+    cerr << jobs.size() << " positions up to ply " << plies << "\n";
+
+    vector<BookEntry> entries(jobs.size());
+    atomic<size_t> next{0}, done{0};
+    mutex progressLock;
+    auto work = [&] {
+        SearchConfig cfg;
+        cfg.maxDepth   = depth;
+        cfg.moveTimeMs = moveTimeMs;
+        cfg.hashMB     = hashMB;
+        SmartPlayer sp("bookgen", cfg);
+        for (size_t j = next++; j < jobs.size(); j = next++) {
+            Scaffold s(cols, levels, N);
+            int color = RED;
+            for (int c : jobs[j].moves) {
+                s.makeMove(c, color);
+                color = (color == RED ? BLACK : RED);
+            }
+            sp.chooseMove(s, N, jobs[j].color);
+            const SearchInfo& info = sp.lastSearch();
+            BookEntry& e = entries[j];
+            e.key      = SmartPlayer::bookKey(s, jobs[j].color);
+            e.score    = info.score;
+            e.move     = static_cast<uint16_t>(SmartPlayer::bookMove(s, info.move));
+            e.depth    = static_cast<uint8_t>(min(info.depth, 255));
+            e.reserved = 0;
+            size_t n = ++done;
+            lock_guard<mutex> guard(progressLock);
+            fprintf(stderr, "\r%zu/%zu", n, jobs.size());
+            fflush(stderr);
+        }
+    };
+    vector<thread> pool;
+    for (int i = 1; i < threads; i++) pool.emplace_back(work);
+    work();
+    for (thread& t : pool) t.join();
+    fprintf(stderr, "\n");
+
+    if (!OpeningBook::write(out, cols, levels, N, entries)) {
+        cerr << "could not write " << out << "\n";
+        return 1;
+    }
+    OpeningBook check;
+    check.open(out);
+    cout << "wrote " << out << ": " << check.size() << " positions\n";
+    return 0;
+}
@@ -0,0 +1,150 @@
+// tools/host.cpp
+//
+// Hosts many bot games at once on a fixed pool of threads (GameScheduler)
+// and reports moves per second and per-move latency.  Built by the
+// top-level CMakeLists.txt (target `host`):
+//
+//   cmake -S . -B build && cmake --build build --target host
+//   ./host smart mcts --games 1000 --threads 4 --nodes 2000
+//
+// Players: smart, mcts, bad (two fresh players per game).
+// Options:
+//   --games n        games played at the same time (default 1000)
+//   --threads n      pool threads (default: hardware threads)
+//   --board CxLxN    columns x levels x win length (default 7x6x4)
+//   --movetime ms    per-move time budget (default 0 = none)
+//   --nodes n        per-move node/playout budget (default 2000)
+//   --hash mb        smart players' table size (default 1)
+//   --baseline 1     also play the same games with one thread per game
+//
+// Every game holds its players for its whole length, so memory grows with
+// --games (about 2 * --hash MB per game of smart players, which therefore
+// play without the exact solver).
+
+#include "Scheduler.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static unique_ptr<Player> makePlayer(const string& type, int hashMB) {
+    if (type == "smart") {
+        SearchConfig cfg;
+        cfg.hashMB = hashMB;
+        cfg.solverMaxEmpty = 0;  // the solver's own table is 16 MB a player
+        return unique_ptr<Player>(new SmartPlayer("smart", cfg));
+    }
+    if (type == "mcts") {
+        MCTSConfig cfg;
+        cfg.poolNodes = 1 << 14;
+        return unique_ptr<Player>(new MCTSPlayer("mcts", cfg));
+    }
+    if (type == "bad")
+        return unique_ptr<Player>(new BadPlayer("bad"));
+    return unique_ptr<Player>();
+}
+
+struct Match {
+    unique_ptr<Player> red, black;
+    unique_ptr<Game>   game;
+};
+
+static bool setUp(vector<Match>& matches, int games, const string& a, const string& b,
+                  int cols, int levels, int N, int hashMB) {
+    matches.clear();
+    matches.resize(games);
+    for (int i = 0; i < games; i++) {
+        Match& m = matches[i];
+        m.red   = makePlayer(i % 2 ? b : a, hashMB);
+        m.black = makePlayer(i % 2 ? a : b, hashMB);
+        if (!m.red || !m.black) return false;
+        m.game.reset(new Game(cols, levels, N, m.red.get(), m.black.get()));
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "usage: host <playerA> <playerB> [options]\n";
+        return 2;
+    }
+    string a = argv[1], b = argv[2];
+    SchedulerConfig cfg;
+    cfg.budget.nodes = 2000;
+    int games = 1000, cols = 7, levels = 6, N = 4, hashMB = 1;
+    bool baseline = false;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        const char* opt = argv[i];
+        const char* val = argv[i + 1];
+        if      (!strcmp(opt, "--games"))    games                  = atoi(val);
+        else if (!strcmp(opt, "--threads"))  cfg.threads            = atoi(val);
+        else if (!strcmp(opt, "--movetime")) cfg.budget.moveTimeMs  = atoi(val);
+        else if (!strcmp(opt, "--nodes"))    cfg.budget.nodes       = atoll(val);
+        else if (!strcmp(opt, "--hash"))     hashMB                 = atoi(val);
+        else if (!strcmp(opt, "--baseline")) baseline               = atoi(val) != 0;
+        else if (!strcmp(opt, "--board"))
+            sscanf(val, "%dx%dx%d", &cols, &levels, &N);
+        else {
+            cerr << "unknown option " << opt << "\n";
+            return 2;
+        }
+    }
+
+    vector<Match> matches;
+    if (!setUp(matches, games, a, b, cols, levels, N, hashMB)) {
+        cerr << "unknown player type (smart, mcts, bad)\n";
+        return 2;
+    }
+    int wins[4] = { 0, 0, 0, 0 };  // by winner: VACANT, RED, BLACK, TIE
+    mutex lock;
+    SchedulerStats st;
+    {
+        GameScheduler scheduler(cfg);
+        for (Match& m : matches)
+            scheduler.add(*m.game, [&](Game&, int winner) {
+                lock_guard<mutex> guard(lock);
+                wins[winner >= 0 && winner <= 3 ? winner : 0]++;
+            });
+        scheduler.wait();
+        st = scheduler.stats();
+    }
+    printf("%s vs %s on %dx%d N=%d: %lld games at once, %lld finished\n",
+           a.c_str(), b.c_str(), cols, levels, N, st.games, st.finished);
+    printf("red %d  black %d  tie %d\n", wins[RED], wins[BLACK], wins[TIE]);
+    printf("pool: %lld moves in %.2f s, %.0f moves/sec, think %.3f ms/move\n",
+           st.moves, st.seconds, st.movesPerSec, st.thinkMs);
+    printf("      latency ms p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n",
+           st.p50, st.p90, st.p99, st.maxMs);
+
+    if (baseline) {
+        // The same games, each driven by a thread of its own
+        setUp(matches, games, a, b, cols, levels, N, hashMB);
+        long long moves = 0;
+        auto start = chrono::steady_clock::now();
+        vector<thread> threads;
+        for (Match& m : matches)
+            threads.emplace_back([&cfg, &moves, &lock, &m] {
+                Game::Turn t;
+                long long n = 0;
+                while (m.game->nextTurn(t)) {
+                    t.player->setTimeControl(t.timed ? t.budget : cfg.budget);
+                    m.game->playTurn(t.player->chooseMove(*t.position, t.N, t.color), 0);
+                    n++;
+                }
+                lock_guard<mutex> guard(lock);
+                moves += n;
+            });
+        for (thread& t : threads) t.join();
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        printf("thread per game: %lld moves in %.2f s, %.0f moves/sec\n",
+               moves, sec, sec > 0 ? moves / sec : 0.0);
+    }
+    return 0;
+}
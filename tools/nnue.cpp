@@ -0,0 +1,467 @@
+// tools/nnue.cpp
+//
+// Trains the small evaluation network (Nnue.h) on self-play positions,
+// writes it as a network file and reports its speed and strength against
+// the handcrafted evaluation.  Built by the top-level CMakeLists.txt
+// (target `nnue`):
+//
+//   cmake -S . -B build && cmake --build build --target nnue
+//   ./nnue --board 7x6x4 --games 4000 --out 7x6x4.nnue
+//   ./arena ...  /  SearchConfig::nnuePath = "7x6x4.nnue"
+//
+// 1. Self-play: fixed-depth SmartPlayers with the handcrafted evaluation
+//    play games from random openings, one game per task on a WorkerPool of
+//    every core.  Each position after the opening where the side to move
+//    cannot win at once is kept with its search score and the game's
+//    result for that side, and so is its mirror image.
+// 2. Training: the target is lambda * result + (1 - lambda) * sigmoid(K *
+//    score), K fitted to the search scores as tools/tune.cpp fits it to the
+//    static ones.  A float copy of the network, with clipped ReLUs and its
+//    output read as K * points, follows the gradient of the mean squared
+//    error to sigmoid(output) over minibatches (Adam).  Layer-2 weights are
+//    kept within what int8 holds after scaling.  One game in ten is held
+//    out to check the fit.
+// 3. The weights are rounded to the fixed point NnueNetwork runs in and
+//    written to --out.
+// 4. Report: held-out error of the float and the quantized network, nodes
+//    per second of fixed-depth searches with either evaluation, and the
+//    network against the handcrafted evaluation in an Arena match at equal
+//    time per move.
+//
+// Options:
+//   --board CxLxN    columns x levels x win length (default 7x6x4)
+//   --games n        self-play games (default 4000)
+//   --depth n        self-play search depth (default 5)
+//   --opening n      random opening plies (default 6)
+//   --threads n      threads for self-play and training (default: hardware)
+//   --epochs n       passes over the training positions (default 30)
+//   --batch n        positions per gradient step (default 256)
+//   --lambda x       weight of the game result in the target (default 0.5)
+//   --out file       network (default <C>x<L>x<N>.nnue)
+//   --match n        report games (default 200, 0 = no report)
+//   --movetime ms    report time per move (default 50)
+//   --seed n         opening and initial weight seed (default 1)
+
+#include "Arena.h"
+#include "Nnue.h"
+#include "SelfPlay.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static const int H  = NnueNetwork::HIDDEN;
+static const int H2 = NnueNetwork::HIDDEN2;
+
+struct Sample {
+    vector<uint16_t> own, opp;  // cells of the side to move's and the opponent's checkers
+    int    score;               // search score for the side to move
+    double result;              // for the side to move
+    double target;
+    bool   heldOut;
+};
+
+static int cellOf(int col, int level, int levels) { return (col - 1) * levels + level - 1; }
+
+// One self-play game's positions, and their mirror images, with the search
+// score and the game's result
+static vector<Sample> playGame(const SelfPlayConfig& cfg, int game) {
+    vector<Sample> out;
+    vector<int> movers;
+    GameState end = selfPlay(cfg, game, [&](const Scaffold& s, int color, const SmartPlayer& sp) {
+        for (int mirror = 0; mirror < 2; mirror++) {
+            Sample x;
+            for (int c = 1; c <= cfg.cols; c++)
+                for (int r = 1; r <= cfg.levels && s.checkerAt(c, r) != VACANT; r++) {
+                    int cell = cellOf(mirror ? cfg.cols + 1 - c : c, r, cfg.levels);
+                    (s.checkerAt(c, r) == color ? x.own : x.opp).push_back(uint16_t(cell));
+                }
+            x.score   = sp.lastSearch().score;
+            x.heldOut = heldOut(game);
+            out.push_back(move(x));
+            movers.push_back(color);
+        }
+    });
+    for (size_t i = 0; i < out.size(); i++) out[i].result = resultFor(end, movers[i]);
+    return out;
+}
+
+static double sigmoid(double x) { return 1 / (1 + exp(-x)); }
+
+// The K that makes sigmoid(K * score) fit the results best: a scan over
+// powers of two, then a golden-section search around the best of them
+static double fitK(const vector<Sample>& data) {
+    auto error = [&data](double k) {
+        double sum = 0;
+        long long n = 0;
+        for (const Sample& x : data) {
+            if (x.heldOut) continue;
+            double d = x.result - sigmoid(k * x.score);
+            sum += d * d;
+            n++;
+        }
+        return n > 0 ? sum / n : 0;
+    };
+    double best = 1.0 / 64, bestErr = 2;
+    for (double k = 1.0 / 4096; k <= 4; k *= 2) {
+        double err = error(k);
+        if (err < bestErr) { bestErr = err; best = k; }
+    }
+    double lo = best / 2, hi = best * 2;
+    const double g = (sqrt(5.0) - 1) / 2;
+    for (int i = 0; i < 40; i++) {
+        double a = hi - g * (hi - lo), b = lo + g * (hi - lo);
+        if (error(a) < error(b)) hi = b;
+        else                     lo = a;
+    }
+    return (lo + hi) / 2;
+}
+
+//––– Float network ––––––––––––––––––––––––––––––––––––––––––––––––––––––––
+// The same shape as NnueNetwork in real numbers: activations in 0..1 and
+// an output in units of K * points.  All parameters sit in one vector so
+// Adam and the per-thread gradients can treat them alike.
+struct FloatNet {
+    int cells;
+    vector<double> p;
+    size_t w1, b1, w2, b2, w3, b3;  // offsets into p
+
+    explicit FloatNet(int cells) : cells(cells) {
+        w1 = 0;
+        b1 = w1 + size_t(2) * cells * H;
+        w2 = b1 + H;
+        b2 = w2 + H2 * 2 * H;
+        w3 = b2 + H2;
+        b3 = w3 + H2;
+        p.assign(b3 + 1, 0);
+    }
+
+    void init(unsigned seed) {
+        mt19937 rng(seed);
+        uniform_real_distribution<double> u(-1, 1);
+        for (size_t i = w1; i < b1; i++) p[i] = 0.1 * u(rng);
+        for (size_t i = b1; i < w2; i++) p[i] = 0.5;
+        for (size_t i = w2; i < b2; i++) p[i] = u(rng) / sqrt(2.0 * H);
+        for (size_t i = b2; i < w3; i++) p[i] = 0.5;
+        for (size_t i = w3; i < b3; i++) p[i] = u(rng) / sqrt(double(H2));
+    }
+
+    // Output for the sample; with `grad`, adds d(error)/d(p) for `target`
+    // to it and returns the prediction's error
+    double forward(const Sample& x, double* grad = nullptr, double target = 0) const {
+        double acc[2][H], in[2 * H], z[H2], h[H2];
+        for (int side = 0; side < 2; side++) {
+            // side 0 sees the position as the side to move does
+            const vector<uint16_t>& mine = side == 0 ? x.own : x.opp;
+            const vector<uint16_t>& theirs = side == 0 ? x.opp : x.own;
+            for (int i = 0; i < H; i++) acc[side][i] = p[b1 + i];
+            for (uint16_t c : mine)
+                for (int i = 0; i < H; i++) acc[side][i] += p[w1 + size_t(c) * H + i];
+            for (uint16_t c : theirs)
+                for (int i = 0; i < H; i++) acc[side][i] += p[w1 + size_t(cells + c) * H + i];
+            for (int i = 0; i < H; i++) in[side * H + i] = min(max(acc[side][i], 0.0), 1.0);
+        }
+        double out = p[b3];
+        for (int j = 0; j < H2; j++) {
+            z[j] = p[b2 + j];
+            for (int i = 0; i < 2 * H; i++) z[j] += in[i] * p[w2 + size_t(j) * 2 * H + i];
+            h[j] = min(max(z[j], 0.0), 1.0);
+            out += h[j] * p[w3 + j];
+        }
+        if (!grad) return out;
+
+        double y = sigmoid(out);
+        double dOut = -2 * (target - y) * y * (1 - y);
+        double dIn[2 * H] = {};
+        grad[b3] += dOut;
+        for (int j = 0; j < H2; j++) {
+            grad[w3 + j] += dOut * h[j];
+            if (z[j] <= 0 || z[j] >= 1) continue;
+            double dz = dOut * p[w3 + j];
+            grad[b2 + j] += dz;
+            for (int i = 0; i < 2 * H; i++) {
+                grad[w2 + size_t(j) * 2 * H + i] += dz * in[i];
+                dIn[i] += dz * p[w2 + size_t(j) * 2 * H + i];
+            }
+        }
+        for (int side = 0; side < 2; side++) {
+            const vector<uint16_t>& mine = side == 0 ? x.own : x.opp;
+            const vector<uint16_t>& theirs = side == 0 ? x.opp : x.own;
+            for (int i = 0; i < H; i++) {
+                double a = acc[side][i];
+                double d = (a > 0 && a < 1) ? dIn[side * H + i] : 0;
+                if (d == 0) continue;
+                grad[b1 + i] += d;
+                for (uint16_t c : mine)   grad[w1 + size_t(c) * H + i] += d;
+                for (uint16_t c : theirs) grad[w1 + size_t(cells + c) * H + i] += d;
+            }
+        }
+        double e = target - y;
+        return e * e;
+    }
+};
+
+// Mean squared error of sigmoid(output) against the targets
+static double meanError(const vector<Sample>& data, bool heldOut, int threads,
+                        const function<double(const Sample&)>& output) {
+    vector<double> sum(threads, 0), count(threads, 0);
+    parallelFor(data.size(), threads, [&](size_t b, size_t e, int slot) {
+        for (size_t i = b; i < e; i++) {
+            if (data[i].heldOut != heldOut) continue;
+            double d = data[i].target - sigmoid(output(data[i]));
+            sum[slot] += d * d;
+            count[slot]++;
+        }
+    });
+    double s = 0, n = 0;
+    for (int i = 0; i < threads; i++) { s += sum[i]; n += count[i]; }
+    return n > 0 ? s / n : 0;
+}
+
+static void train(FloatNet& net, const vector<Sample>& data, int epochs, int batch,
+                  int threads, unsigned seed) {
+    const double rate = 1e-3, beta1 = 0.9, beta2 = 0.999, eps = 1e-8;
+    const double w2Max = double(INT8_MAX) / NnueNetwork::W2_SCALE;
+    vector<size_t> order;
+    for (size_t i = 0; i < data.size(); i++)
+        if (!data[i].heldOut) order.push_back(i);
+    mt19937 rng(seed);
+    size_t n = net.p.size();
+    vector<double> m(n, 0), v(n, 0), grad(n);
+    vector<vector<double>> partial(threads, vector<double>(n));
+    long long step = 0;
+    for (int epoch = 0; epoch < epochs; epoch++) {
+        shuffle(order.begin(), order.end(), rng);
+        double loss = 0;
+        for (size_t first = 0; first < order.size(); first += batch) {
+            size_t count = min(order.size() - first, size_t(batch));
+            vector<double> batchLoss(threads, 0);
+            parallelFor(count, threads, [&](size_t b, size_t e, int slot) {
+                vector<double>& g = partial[slot];
+                fill(g.begin(), g.end(), 0);
+                for (size_t i = b; i < e; i++) {
+                    const Sample& x = data[order[first + i]];
+                    batchLoss[slot] += net.forward(x, g.data(), x.target);
+                }
+            });
+            fill(grad.begin(), grad.end(), 0);
+            for (int t = 0; t < threads; t++) {
+                loss += batchLoss[t];
+                for (size_t j = 0; j < n; j++) grad[j] += partial[t][j];
+            }
+            step++;
+            double c1 = 1 - pow(beta1, double(step)), c2 = 1 - pow(beta2, double(step));
+            for (size_t j = 0; j < n; j++) {
+                double gj = grad[j] / count;
+                m[j] = beta1 * m[j] + (1 - beta1) * gj;
+                v[j] = beta2 * v[j] + (1 - beta2) * gj * gj;
+                net.p[j] -= rate * (m[j] / c1) / (sqrt(v[j] / c2) + eps);
+            }
+            for (size_t j = net.w2; j < net.b2; j++)
+                net.p[j] = min(max(net.p[j], -w2Max), w2Max);
+        }
+        fprintf(stderr, "\repoch %d/%d  train mse %.5f   ", epoch + 1, epochs,
+                loss / max<size_t>(order.size(), 1));
+    }
+    fprintf(stderr, "\n");
+}
+
+// The float network in NnueNetwork's fixed point; the output of K * points
+// turns back into points by dividing the last layer by K
+static NnueNetwork quantize(const FloatNet& f, int cols, int levels, int N, double K) {
+    const double act = NnueNetwork::ACT_MAX;
+    auto to = [](double x, double lo, double hi) { return lround(min(max(x, lo), hi)); };
+    NnueNetwork q(cols, levels, N);
+    for (int r = 0; r < 2 * f.cells; r++)
+        for (int i = 0; i < H; i++)
+            q.w1[r][i] = int16_t(to(f.p[f.w1 + size_t(r) * H + i] * act, INT16_MIN, INT16_MAX));
+    for (int i = 0; i < H; i++)
+        q.b1[i] = int16_t(to(f.p[f.b1 + i] * act, INT16_MIN, INT16_MAX));
+    for (int i = 0; i < H2 * 2 * H; i++)
+        q.w2[i] = int8_t(to(f.p[f.w2 + i] * NnueNetwork::W2_SCALE, INT8_MIN, INT8_MAX));
+    for (int j = 0; j < H2; j++) {
+        q.b2[j] = int32_t(to(f.p[f.b2 + j] * act * NnueNetwork::W2_SCALE, -1e9, 1e9));
+        q.w3[j] = int16_t(to(f.p[f.w3 + j] / K * NnueNetwork::OUT_SCALE, INT16_MIN, INT16_MAX));
+    }
+    q.b3 = int32_t(to(f.p[f.b3] / K * act * NnueNetwork::OUT_SCALE, -1e9, 1e9));
+    return q;
+}
+
+// Points the quantized network gives a sample, built up checker by checker
+static int quantizedScore(const NnueNetwork& net, const Sample& x) {
+    vector<int> board(net.cells(), VACANT);
+    for (uint16_t c : x.own) board[c] = RED;
+    for (uint16_t c : x.opp) board[c] = BLACK;
+    NnueState st;
+    st.reset(&net);
+    for (int c = 0; c < net.cells(); c++)
+        if (board[c] != VACANT) st.play(c / net.levels() + 1, board[c]);
+    return st.score(RED);
+}
+
+// Nodes per second of fixed-depth searches, handcrafted or by the network
+static double searchNps(int cols, int levels, int N, int depth, const string& nnuePath,
+                        long long& nodes) {
+    SearchConfig cfg;
+    cfg.maxDepth       = depth;
+    cfg.moveTimeMs     = 3600 * 1000;
+    cfg.solverMaxEmpty = 0;
+    cfg.nnuePath       = nnuePath;
+    nodes = 0;
+    double ms = 0;
+    mt19937 rng(99);
+    for (int pos = 0; pos < 8; pos++) {
+        Scaffold s(cols, levels, N);
+        int color = RED;
+        for (int i = 0; i < 2 * pos && s.state() == PLAYING;) {
+            if (!s.makeMove(1 + static_cast<int>(rng() % cols), color)) continue;
+            color = (color == RED ? BLACK : RED);
+            i++;
+        }
+        if (s.state() != PLAYING) continue;
+        SmartPlayer sp("nps", cfg);
+        sp.chooseMove(s, N, color);
+        nodes += sp.lastSearch().nodes;
+        ms += sp.lastSearch().ms;
+    }
+    return ms > 0 ? nodes * 1000.0 / ms : 0;
+}
+
+int main(int argc, char* argv[]) {
+    int cols = 7, levels = 6, N = 4, games = 4000, depth = 5, openingPlies = 6;
+    int threads = max(1u, thread::hardware_concurrency()), epochs = 30, batch = 256;
+    int matchGames = 200, moveTimeMs = 50;
+    double lambda = 0.5;
+    unsigned seed = 1;
+    string out;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* opt = argv[i];
+        const char* val = argv[i + 1];
+        if      (!strcmp(opt, "--games"))    games        = atoi(val);
+        else if (!strcmp(opt, "--depth"))    depth        = atoi(val);
+        else if (!strcmp(opt, "--opening"))  openingPlies = atoi(val);
+        else if (!strcmp(opt, "--threads"))  threads      = max(1, atoi(val));
+        else if (!strcmp(opt, "--epochs"))   epochs       = atoi(val);
+        else if (!strcmp(opt, "--batch"))    batch        = max(1, atoi(val));
+        else if (!strcmp(opt, "--lambda"))   lambda       = atof(val);
+        else if (!strcmp(opt, "--out"))      out          = val;
+        else if (!strcmp(opt, "--match"))    matchGames   = atoi(val);
+        else if (!strcmp(opt, "--movetime")) moveTimeMs   = atoi(val);
+        else if (!strcmp(opt, "--seed"))     seed         = strtoul(val, nullptr, 10);
+        else if (!strcmp(opt, "--board"))
+            sscanf(val, "%dx%dx%d", &cols, &levels, &N);
+        else {
+            cerr << "unknown option " << opt << "\n";
+            return 2;
+        }
+    }
+    if (cols < 1 || levels < 1 || cols * levels > UINT16_MAX || N < 1) {
+        cerr << "bad board " << cols << "x" << levels << "x" << N << "\n";
+        return 2;
+    }
+    if (out.empty())
+        out = to_string(cols) + "x" + to_string(levels) + "x" + to_string(N) + ".nnue";
+
+    // 1. Self-play
+    auto t0 = chrono::steady_clock::now();
+    SelfPlayConfig play;
+    play.cols         = cols;
+    play.levels       = levels;
+    play.N            = N;
+    play.depth        = depth;
+    play.openingPlies = openingPlies;
+    play.seed         = seed;
+    vector<Sample> data = playGames<Sample>(games, threads, [&play](int g) {
+        return playGame(play, g);
+    });
+    long long heldOut = count_if(data.begin(), data.end(), [](const Sample& x) { return x.heldOut; });
+    double playSec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    fprintf(stderr, "self-play: %d games, %zu positions in %.1f s\n", games, data.size(), playSec);
+
+    // 2. Training
+    t0 = chrono::steady_clock::now();
+    double K = fitK(data);
+    for (Sample& x : data) x.target = lambda * x.result + (1 - lambda) * sigmoid(K * x.score);
+    FloatNet net(cols * levels);
+    net.init(seed);
+    train(net, data, epochs, batch, threads, seed);
+    double trainSec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    // 3. Network file
+    NnueNetwork q = quantize(net, cols, levels, N, K);
+    if (!q.save(out)) {
+        cerr << "cannot write " << out << "\n";
+        return 1;
+    }
+
+    // 4. Report
+    auto floatOut = [&net](const Sample& x) { return net.forward(x); };
+    auto fixedOut = [&q, K](const Sample& x) { return K * quantizedScore(q, x); };
+    auto searchOut = [K](const Sample& x) { return K * x.score; };
+    printf("Network training on %dx%d N=%d: 2x%d inputs, 2x%d, %d, 1 units\n",
+           cols, levels, N, 2 * cols * levels, H, H2);
+    printf("self-play  %d games at depth %d, %d opening plies: %zu positions with "
+           "mirrors (%lld held out), %.1f s on %d threads\n",
+           games, depth, openingPlies, data.size(), heldOut, playSec, threads);
+    printf("train      K %.6g, lambda %.2f, %d epochs of %d, %.1f s\n",
+           K, lambda, epochs, batch, trainSec);
+    printf("%-10s %10s %10s\n", "model", "train mse", "held mse");
+    auto row = [&](const char* name, const function<double(const Sample&)>& f) {
+        printf("%-10s %10.5f %10.5f\n", name, meanError(data, false, threads, f),
+               meanError(data, true, threads, f));
+    };
+    row("search", searchOut);
+    row("float", floatOut);
+    row("quantized", fixedOut);
+    printf("written to %s (%s layers 2-3)\n", out.c_str(),
+           EvalKernel::name(EvalKernel::detect()));
+
+    int npsDepth = cols * levels <= 64 ? 10 : 6;
+    long long hNodes, nNodes;
+    double hNps = searchNps(cols, levels, N, npsDepth, "", hNodes);
+    double nNps = searchNps(cols, levels, N, npsDepth, out, nNodes);
+    printf("speed      depth %d on 8 positions: handcrafted %lld nodes, %.0f nps; "
+           "network %lld nodes, %.0f nps (%.2fx)\n",
+           npsDepth, hNodes, hNps, nNodes, nNps, hNps > 0 ? nNps / hNps : 0);
+
+    if (matchGames > 0) {
+        ArenaConfig cfg;
+        cfg.cols       = cols;
+        cfg.levels     = levels;
+        cfg.N          = N;
+        cfg.games      = matchGames + matchGames % 2;
+        cfg.threads    = threads;
+        cfg.moveTimeMs = moveTimeMs;
+        cfg.seed       = seed;
+        auto factory = [](const char* name, const string& path) {
+            return [name, path] {
+                SearchConfig sc;
+                sc.nnuePath = path;
+                return unique_ptr<Player>(new SmartPlayer(name, sc));
+            };
+        };
+        ArenaResult r = runArena(cfg, factory("network", out), factory("handcrafted", ""),
+                                 [](const ArenaResult& p) {
+            fprintf(stderr, "\r+%d =%d -%d  elo %+.1f +/- %.1f   ",
+                    p.wins, p.draws, p.losses, p.elo, p.eloError);
+        });
+        fprintf(stderr, "\n");
+        printf("match      network vs handcrafted, %d games at %d ms/move: W/D/L %d/%d/%d  "
+               "score %.1f%%  elo %+.1f +/- %.1f (95%%)\n",
+               r.wins + r.draws + r.losses, moveTimeMs, r.wins, r.draws, r.losses,
+               100 * r.score, r.elo, r.eloError);
+    }
+    return 0;
+}
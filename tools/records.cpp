@@ -0,0 +1,79 @@
+// tools/records.cpp
+//
+// Summarizes game record files (GameRecord.h), e.g. those written by
+// `arena --record`, and times a full replay of every position in them.
+// Built by the top-level CMakeLists.txt (target `records`):
+//
+//   cmake -S . -B build && cmake --build build --target records
+//   ./records games.cng [more.cng ...]
+//
+// For each file: games, moves, bytes per game and move, results (with how
+// many were lost on time), and positions replayed per second.  The replay
+// keeps one Scaffold per board size, so it allocates nothing per game.
+
+#include "GameRecord.h"
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <tuple>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: records <file> [file ...]\n");
+        return 2;
+    }
+    int status = 0;
+    for (int i = 1; i < argc; i++) {
+        GameRecordReader reader;
+        if (!reader.open(argv[i])) {
+            fprintf(stderr, "%s: not a game record file\n", argv[i]);
+            status = 1;
+            continue;
+        }
+
+        long long games = 0, moves = 0, scored = 0, onTime = 0;
+        long long results[4] = { 0, 0, 0, 0 };
+        GameView g;
+        while (reader.next(g)) {
+            games++;
+            moves += g.numMoves;
+            if (g.hasScores) scored++;
+            if (g.onTime) onTime++;
+            if (g.result >= PLAYING && g.result <= TIE) results[g.result]++;
+        }
+        size_t bytes = reader.fileBytes() - sizeof(GameFileHeader);
+        printf("%s: %lld games, %lld moves, %.1f bytes/game, %.2f bytes/move\n",
+               argv[i], games, moves, games ? double(bytes) / games : 0.0,
+               moves ? double(bytes) / moves : 0.0);
+        printf("  red %lld  black %lld  tie %lld  unfinished %lld  (%lld on time)"
+               "  with scores %lld\n", results[REDWIN], results[BLACKWIN],
+               results[TIE], results[PLAYING], onTime, scored);
+
+        // Replay: touch every position so the walk cannot be optimized out
+        map<tuple<int,int>, unique_ptr<Scaffold>> boards;
+        long long positions = 0, checksum = 0, bad = 0;
+        auto start = chrono::steady_clock::now();
+        reader.rewind();
+        while (reader.next(g)) {
+            unique_ptr<Scaffold>& s = boards[make_tuple(g.cols, g.levels)];
+            if (!s) s.reset(new Scaffold(g.cols, g.levels, g.N));
+            bool ok = g.forEachPosition(*s, [&](const Scaffold& b, int col, int color,
+                                                int score, int timeMs) {
+                positions++;
+                checksum += b.state() + col * color;
+            });
+            if (!ok) bad++;
+        }
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        printf("  replayed %lld positions in %.3f s, %.1fM positions/sec (check %lld)\n",
+               positions, sec, sec > 0 ? positions / sec / 1e6 : 0.0, checksum);
+        if (bad) {
+            printf("  %lld games with an illegal move or an unusable board\n", bad);
+            status = 1;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,159 @@
+// tools/server.cpp
+//
+// Long-running analysis engine (AnalysisServer.h): reads request lines on
+// stdin and writes replies on stdout, or serves any number of clients on a
+// Unix domain socket.  Built by the top-level CMakeLists.txt (target
+// `server`):
+//
+//   cmake -S . -B build && cmake --build build --target server
+//   printf 'analyze 1 7x6x4 4453 movetime 100\nstats\n' | ./server --workers 4
+//   ./server --socket /tmp/connectn.sock &
+//   printf 'analyze a 7x6x4 - depth 10\nquit\n' | nc -U /tmp/connectn.sock
+//
+// Options:
+//   --workers n      searches in parallel (default: hardware threads)
+//   --batch n        most requests one worker takes at a time (default 8)
+//   --threads n      search threads per worker (default 1)
+//   --hash mb        transposition table per worker (default 16)
+//   --movetime ms    budget for requests that give no limits (default 1000)
+//   --book file      opening book
+//   --solvedb file   solve database
+//   --eval file      evaluation weights (tools/tune.cpp)
+//   --nnue file      evaluation network (tools/nnue.cpp)
+//   --socket path    listen here instead of on stdin (not on Windows)
+//
+// On stdin, "quit" or the end of input answers what is queued and exits,
+// printing the latency percentiles to stderr.  On a socket, "quit" closes
+// that client's connection.
+
+#include "AnalysisServer.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define SERVER_SOCKETS
+#endif
+
+using namespace std;
+
+#ifdef SERVER_SOCKETS
+// One client.  Replies can still be on their way after the client has
+// sent "quit", so the descriptor is closed with the last reference.
+struct Connection {
+    explicit Connection(int f) : fd(f) {}
+    ~Connection() { close(fd); }
+    int fd;
+};
+
+static void serveClient(AnalysisServer& server, int fd) {
+    shared_ptr<Connection> conn(new Connection(fd));
+    AnalysisServer::Reply reply = [conn](const string& line) {
+        string out = line + "\n";
+        for (size_t done = 0; done < out.size();) {
+            ssize_t n = ::send(conn->fd, out.data() + done, out.size() - done, MSG_NOSIGNAL);
+            if (n <= 0) return;  // client gone
+            done += n;
+        }
+    };
+    string pending;
+    char buf[4096];
+    for (;;) {
+        ssize_t n = recv(fd, buf, sizeof buf, 0);
+        if (n <= 0) break;
+        pending.append(buf, n);
+        size_t start = 0, nl;
+        while ((nl = pending.find('\n', start)) != string::npos) {
+            string line = pending.substr(start, nl - start);
+            start = nl + 1;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (!server.handle(line, reply)) {
+                shutdown(fd, SHUT_RD);
+                return;
+            }
+        }
+        pending.erase(0, start);
+    }
+}
+
+static int serveSocket(AnalysisServer& server, const string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof addr);
+    addr.sun_family = AF_UNIX;
+    if (fd < 0 || path.size() >= sizeof addr.sun_path) {
+        cerr << "cannot listen on " << path << "\n";
+        return 1;
+    }
+    strcpy(addr.sun_path, path.c_str());
+    unlink(path.c_str());
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof addr) != 0
+        || listen(fd, 64) != 0) {
+        cerr << "cannot listen on " << path << "\n";
+        close(fd);
+        return 1;
+    }
+    fprintf(stderr, "listening on %s with %d workers\n", path.c_str(), server.workers());
+    for (;;) {
+        int client = accept(fd, nullptr, nullptr);
+        if (client < 0) continue;
+        thread([&server, client] { serveClient(server, client); }).detach();
+    }
+}
+#endif
+
+int main(int argc, char* argv[]) {
+    ServerConfig cfg;
+    cfg.search.moveTimeMs = 1000;
+    string socketPath;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* opt = argv[i];
+        const char* val = argv[i + 1];
+        if      (!strcmp(opt, "--workers"))  cfg.workers              = atoi(val);
+        else if (!strcmp(opt, "--batch"))    cfg.batch                = atoi(val);
+        else if (!strcmp(opt, "--threads"))  cfg.search.threads       = atoi(val);
+        else if (!strcmp(opt, "--hash"))     cfg.search.hashMB        = atoi(val);
+        else if (!strcmp(opt, "--movetime")) cfg.search.moveTimeMs    = atoi(val);
+        else if (!strcmp(opt, "--book"))     cfg.search.bookPath      = val;
+        else if (!strcmp(opt, "--solvedb"))  cfg.search.solverDbPath  = val;
+        else if (!strcmp(opt, "--eval"))     cfg.search.evalPath      = val;
+        else if (!strcmp(opt, "--nnue"))     cfg.search.nnuePath      = val;
+        else if (!strcmp(opt, "--socket"))   socketPath               = val;
+        else {
+            cerr << "unknown option " << opt << "\n";
+            return 2;
+        }
+    }
+
+    AnalysisServer server(cfg);
+    if (!socketPath.empty()) {
+#ifdef SERVER_SOCKETS
+        return serveSocket(server, socketPath);
+#else
+        cerr << "sockets are not supported here; use stdin\n";
+        return 2;
+#endif
+    }
+
+    AnalysisServer::Reply reply = [](const string& line) {
+        fputs(line.c_str(), stdout);
+        fputc('\n', stdout);
+        fflush(stdout);
+    };
+    string line;
+    while (getline(cin, line) && server.handle(line, reply)) {}
+    server.wait();
+
+    ServerStats st = server.stats();
+    fprintf(stderr, "%lld requests (%lld errors, %lld searches)  latency ms: "
+            "p50 %.2f  p90 %.2f  p99 %.2f  max %.2f  mean %.2f\n",
+            st.requests, st.errors, st.searches, st.p50, st.p90, st.p99,
+            st.maxMs, st.meanMs);
+    return 0;
+}
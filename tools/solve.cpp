@@ -0,0 +1,120 @@
+// tools/solve.cpp
+//
+// Exact solver front end: solves positions on small boards, streams the
+// results into a per-board solve database and reports solve time and
+// database size for each board.  Run it twice to see the database answer
+// instantly.  Built by the top-level CMakeLists.txt (target `solve`), e.g.
+//
+//   cmake -S . -B build && cmake --build build --target solve
+//   ./solve --board 5x4x4 --board 6x5x4 --plies 1
+//
+// Options:
+//   --board CxLxN    board and win length, repeatable (default 5x4x4, 6x5x4)
+//   --moves cols     solve the position after these moves, e.g. 4453
+//   --plies n        also solve every position with n more checkers (default 0)
+//   --movetime ms    give up on a position after this long (default 600000)
+//   --hash log2      solver table entries, as a power of two (default 24)
+//   --db dir         where the <C>x<L>x<N>.solve files live (default .)
+
+#include "Solver.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+struct BoardSpec { int cols, levels, N; };
+
+// Every distinct non-terminal position `plies` moves below `s`
+static void enumerate(Scaffold& s, int color, int plies, const Solver& solver,
+                      unordered_set<uint64_t>& seen, vector<pair<Scaffold,int>>& out) {
+    if (s.state() != PLAYING) return;
+    if (plies == 0) {
+        uint64_t red = s.colorBits(RED)[0], black = s.colorBits(BLACK)[0];
+        if (seen.insert(solver.canonicalKey(color == RED ? red : black, red | black)).second)
+            out.push_back({s, color});
+        return;
+    }
+    for (int c = 1; c <= s.cols(); c++) {
+        if (!s.makeMove(c, color)) continue;
+        enumerate(s, color == RED ? BLACK : RED, plies - 1, solver, seen, out);
+        s.undoMove();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    vector<BoardSpec> boards;
+    string moves, dbDir = ".";
+    int plies = 0, moveTimeMs = 600000, hashLog2 = 24;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* opt = argv[i];
+        const char* val = argv[i + 1];
+        if (!strcmp(opt, "--board")) {
+            BoardSpec b = {7, 6, 4};
+            sscanf(val, "%dx%dx%d", &b.cols, &b.levels, &b.N);
+            boards.push_back(b);
+        }
+        else if (!strcmp(opt, "--moves"))    moves      = val;
+        else if (!strcmp(opt, "--plies"))    plies      = atoi(val);
+        else if (!strcmp(opt, "--movetime")) moveTimeMs = atoi(val);
+        else if (!strcmp(opt, "--hash"))     hashLog2   = atoi(val);
+        else if (!strcmp(opt, "--db"))       dbDir      = val;
+        else {
+            cerr << "unknown option " << opt << "\n";
+            return 2;
+        }
+    }
+    if (boards.empty()) boards = { {5, 4, 4}, {6, 5, 4} };
+
+    for (const BoardSpec& b : boards) {
+        string name = to_string(b.cols) + "x" + to_string(b.levels) + "x" + to_string(b.N);
+        if (!Solver::supports(b.cols, b.levels, b.N)) {
+            cout << name << ": too large for the solver\n";
+            continue;
+        }
+        SolveDatabase db;
+        if (!db.open(dbDir + "/" + name + ".solve", b.cols, b.levels, b.N)) {
+            cerr << name << ": not a solve database for this board\n";
+            return 1;
+        }
+        Solver solver(b.cols, b.levels, b.N, hashLog2);
+        solver.setDatabase(&db);
+
+        Scaffold root(b.cols, b.levels, b.N);
+        int color = RED;
+        for (char ch : moves)
+            if (root.makeMove(ch - '0', color)) color = (color == RED ? BLACK : RED);
+        unordered_set<uint64_t> seen;
+        vector<pair<Scaffold,int>> positions;
+        enumerate(root, color, plies, solver, seen, positions);
+
+        size_t before = db.size();
+        int solved = 0;
+        double totalMs = 0;
+        for (const auto& p : positions) {
+            auto start = chrono::steady_clock::now();
+            long long nodes = solver.nodes();
+            AlarmClock ac(moveTimeMs);
+            int score = 0;
+            bool ok = solver.solve(p.first, p.second, score, &ac);
+            double ms = chrono::duration<double, milli>(
+                            chrono::steady_clock::now() - start).count();
+            totalMs += ms;
+            if (ok) solved++;
+            if (positions.size() == 1 || !ok)
+                printf("%s  score %s  nodes %lld  %.1f ms\n", name.c_str(),
+                       ok ? to_string(score).c_str() : "?", solver.nodes() - nodes, ms);
+        }
+        db.flush();
+        printf("%s  %d/%zu positions solved  nodes %lld  %.1f ms  "
+               "db %zu records (+%zu)  %zu bytes\n",
+               name.c_str(), solved, positions.size(), solver.nodes(), totalMs,
+               db.size(), db.size() - before, db.fileBytes());
+    }
+    return 0;
+}
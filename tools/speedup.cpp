@@ -0,0 +1,71 @@
+// tools/speedup.cpp
+//
+// Lazy SMP speedup curve: time-to-depth of SmartPlayer on a fixed set of
+// positions for 1, 2, 4, ... threads.  Built by the top-level
+// CMakeLists.txt (target `speedup`), e.g.
+//
+//   cmake -S . -B build && cmake --build build --target speedup
+//   ./speedup [maxThreads] [hashMB]
+
+#include "GameCore.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+
+using namespace std;
+
+struct BenchPosition {
+    int cols, levels, N, depth;
+    const char* moves;  // columns played so far, RED first
+};
+
+static const BenchPosition kPositions[] = {
+    { 7, 6, 4, 12, "" },
+    { 7, 6, 4, 14, "4453" },
+    { 7, 6, 4, 14, "44433552" },
+    { 7, 6, 4, 16, "3344425566" },
+    { 9, 7, 5, 9,  "" },
+    { 9, 7, 5, 10, "5546" },
+};
+
+int main(int argc, char* argv[]) {
+    int maxThreads = argc > 1 ? atoi(argv[1])
+                              : max(1u, thread::hardware_concurrency());
+    int hashMB     = argc > 2 ? atoi(argv[2]) : 64;
+
+    vector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+
+    cout << "threads  time_ms   nodes        speedup\n";
+    double baseline = 0;
+    for (int t : counts) {
+        double totalMs = 0;
+        long long totalNodes = 0;
+        for (const BenchPosition& p : kPositions) {
+            Scaffold s(p.cols, p.levels, p.N);
+            int color = RED;
+            for (const char* m = p.moves; *m; m++) {
+                s.makeMove(*m - '0', color);
+                color = (color == RED ? BLACK : RED);
+            }
+            SearchConfig cfg;
+            cfg.threads    = t;
+            cfg.hashMB     = hashMB;
+            cfg.maxDepth   = p.depth;
+            cfg.moveTimeMs = 3600 * 1000;
+            SmartPlayer sp("bench", cfg);  // fresh, cold table per position
+            sp.chooseMove(s, p.N, color);
+            totalMs    += sp.lastSearch().ms;
+            totalNodes += sp.lastSearch().nodes;
+        }
+        if (t == 1) baseline = totalMs;
+        cout << setw(7) << t << setw(10) << fixed << setprecision(0) << totalMs
+             << setw(14) << totalNodes
+             << setw(10) << setprecision(2) << baseline / totalMs << "\n";
+    }
+    return 0;
+}
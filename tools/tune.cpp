@@ -0,0 +1,296 @@
+// tools/tune.cpp
+//
+// Tunes the evaluation weights (EvalParams.h) on self-play results and
+// reports how the tuned weights play against the ones they started from.
+// Built by the top-level CMakeLists.txt (target `tune`):
+//
+//   cmake -S . -B build && cmake --build build --target tune
+//   ./tune --board 7x6x4 --games 4000 --out 7x6x4.eval
+//   ./arena ...  /  SearchConfig::evalPath = "7x6x4.eval"
+//
+// 1. Self-play: fixed-depth SmartPlayers play games from random openings,
+//    one game per task on a WorkerPool of every core.  Each position after
+//    the opening where the side to move cannot win at once is kept with
+//    the game's result for that side (1, 1/2 or 0) and its EvalTerms.
+// 2. Fitting (Texel's method): the evaluation is linear in the weights, so
+//    a position scores w . x / SCALE with x read off its terms, and
+//    predicts the result sigmoid(K * score).  K is fitted to the starting
+//    weights and then held while the weights follow the gradient of the
+//    mean squared error (Adam).  Every pass over the positions is split
+//    into one batch per thread.  One game in ten is held out to check the
+//    fit.
+// 3. The rounded weights are written to --out.
+// 4. Report: the tuned weights against the starting ones in an Arena match
+//    at equal time per move.
+//
+// Options:
+//   --board CxLxN    columns x levels x win length (default 7x6x4)
+//   --games n        self-play games (default 4000)
+//   --depth n        self-play search depth (default 4)
+//   --opening n      random opening plies (default 6)
+//   --threads n      threads for self-play and fitting (default: hardware)
+//   --epochs n       gradient steps (default 1500)
+//   --params file    weights to start from (default: built in)
+//   --out file       tuned weights (default <C>x<L>x<N>.eval)
+//   --match n        report games (default 200, 0 = no report)
+//   --movetime ms    report time per move (default 50)
+//   --seed n         opening seed (default 1)
+
+#include "Arena.h"
+#include "EvalKernel.h"
+#include "SelfPlay.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static const int FEATURES = 5;  // square, linear, empty, threat, tempo
+
+struct Sample {
+    double x[FEATURES];  // side to move's terms minus the opponent's
+    double result;       // for the side to move
+    bool   heldOut;
+};
+
+static void features(const EvalTerms& own, const EvalTerms& opp, int N, double x[]) {
+    x[0] = double(own.squares - opp.squares);
+    x[1] = double(own.checkers - opp.checkers);
+    x[2] = double((N * own.windows - own.checkers) - (N * opp.windows - opp.checkers));
+    x[3] = double(own.threats - opp.threats);
+    x[4] = 1;
+}
+
+static void toWeights(const EvalParams& p, double w[]) {
+    w[0] = p.square; w[1] = p.linear; w[2] = p.empty; w[3] = p.threat; w[4] = p.tempo;
+}
+
+static EvalParams fromWeights(const double w[]) {
+    EvalParams p;
+    p.square = static_cast<int>(lround(w[0]));
+    p.linear = static_cast<int>(lround(w[1]));
+    p.empty  = static_cast<int>(lround(w[2]));
+    p.threat = static_cast<int>(lround(w[3]));
+    p.tempo  = static_cast<int>(lround(w[4]));
+    return p;
+}
+
+// One self-play game's positions with the game's result
+static vector<Sample> playGame(const SelfPlayConfig& cfg, int game) {
+    vector<Sample> out;
+    vector<int> movers;
+    GameState end = selfPlay(cfg, game, [&](const Scaffold& s, int color, const SmartPlayer&) {
+        EvalTerms t[2];
+        EvalKernel::terms(s, cfg.N, t);
+        Sample x;
+        features(t[color == RED ? 0 : 1], t[color == RED ? 1 : 0], cfg.N, x.x);
+        x.heldOut = heldOut(game);
+        out.push_back(x);
+        movers.push_back(color);
+    });
+    for (size_t i = 0; i < out.size(); i++) out[i].result = resultFor(end, movers[i]);
+    return out;
+}
+
+static double predict(const Sample& x, const double w[], double K) {
+    double score = 0;
+    for (int j = 0; j < FEATURES; j++) score += w[j] * x.x[j];
+    return 1 / (1 + exp(-K * score / EvalParams::SCALE));
+}
+
+// Mean squared error over the held-out or the training positions
+static double meanError(const vector<Sample>& data, const double w[], double K,
+                        bool heldOut, int threads) {
+    vector<double> sum(threads, 0), count(threads, 0);
+    parallelFor(data.size(), threads, [&](size_t b, size_t e, int slot) {
+        for (size_t i = b; i < e; i++) {
+            if (data[i].heldOut != heldOut) continue;
+            double d = data[i].result - predict(data[i], w, K);
+            sum[slot] += d * d;
+            count[slot]++;
+        }
+    });
+    double s = 0, n = 0;
+    for (int i = 0; i < threads; i++) { s += sum[i]; n += count[i]; }
+    return n > 0 ? s / n : 0;
+}
+
+// The K that fits the weights best: a scan over powers of two, then a
+// golden-section search around the best of them
+static double fitK(const vector<Sample>& data, const double w[], int threads) {
+    double best = 1.0 / 64, bestErr = 2;
+    for (double k = 1.0 / 4096; k <= 4; k *= 2) {
+        double err = meanError(data, w, k, false, threads);
+        if (err < bestErr) { bestErr = err; best = k; }
+    }
+    double lo = best / 2, hi = best * 2;
+    const double g = (sqrt(5.0) - 1) / 2;
+    for (int i = 0; i < 40; i++) {
+        double a = hi - g * (hi - lo), b = lo + g * (hi - lo);
+        if (meanError(data, w, a, false, threads) < meanError(data, w, b, false, threads))
+            hi = b;
+        else
+            lo = a;
+    }
+    return (lo + hi) / 2;
+}
+
+static void tune(const vector<Sample>& data, double w[], double K, int epochs, int threads) {
+    const double rate = 0.25, beta1 = 0.9, beta2 = 0.999, eps = 1e-12;
+    double m[FEATURES] = {}, v[FEATURES] = {};
+    vector<array<double, FEATURES + 1>> partial(threads);
+    for (int step = 1; step <= epochs; step++) {
+        parallelFor(data.size(), threads, [&](size_t b, size_t e, int slot) {
+            array<double, FEATURES + 1>& g = partial[slot];
+            g.fill(0);
+            for (size_t i = b; i < e; i++) {
+                if (data[i].heldOut) continue;
+                double p = predict(data[i], w, K);
+                double d = -2 * (data[i].result - p) * p * (1 - p) * K / EvalParams::SCALE;
+                for (int j = 0; j < FEATURES; j++) g[j] += d * data[i].x[j];
+                g[FEATURES]++;
+            }
+        });
+        double grad[FEATURES] = {}, n = 0;
+        for (const auto& g : partial) {
+            for (int j = 0; j < FEATURES; j++) grad[j] += g[j];
+            n += g[FEATURES];
+        }
+        if (n == 0) return;
+        for (int j = 0; j < FEATURES; j++) {
+            double gj = grad[j] / n;
+            m[j] = beta1 * m[j] + (1 - beta1) * gj;
+            v[j] = beta2 * v[j] + (1 - beta2) * gj * gj;
+            double mh = m[j] / (1 - pow(beta1, step)), vh = v[j] / (1 - pow(beta2, step));
+            w[j] -= rate * mh / (sqrt(vh) + eps);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int cols = 7, levels = 6, N = 4, games = 4000, depth = 4, openingPlies = 6;
+    int threads = max(1u, thread::hardware_concurrency()), epochs = 1500;
+    int matchGames = 200, moveTimeMs = 50;
+    unsigned seed = 1;
+    string paramsPath, out;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* opt = argv[i];
+        const char* val = argv[i + 1];
+        if      (!strcmp(opt, "--games"))    games        = atoi(val);
+        else if (!strcmp(opt, "--depth"))    depth        = atoi(val);
+        else if (!strcmp(opt, "--opening"))  openingPlies = atoi(val);
+        else if (!strcmp(opt, "--threads"))  threads      = max(1, atoi(val));
+        else if (!strcmp(opt, "--epochs"))   epochs       = atoi(val);
+        else if (!strcmp(opt, "--params"))   paramsPath   = val;
+        else if (!strcmp(opt, "--out"))      out          = val;
+        else if (!strcmp(opt, "--match"))    matchGames   = atoi(val);
+        else if (!strcmp(opt, "--movetime")) moveTimeMs   = atoi(val);
+        else if (!strcmp(opt, "--seed"))     seed         = strtoul(val, nullptr, 10);
+        else if (!strcmp(opt, "--board"))
+            sscanf(val, "%dx%dx%d", &cols, &levels, &N);
+        else {
+            cerr << "unknown option " << opt << "\n";
+            return 2;
+        }
+    }
+    if (N < 1 || N > EvalKernel::MAX_N) {
+        cerr << "win length must be 1 to " << EvalKernel::MAX_N << "\n";
+        return 2;
+    }
+    if (out.empty())
+        out = to_string(cols) + "x" + to_string(levels) + "x" + to_string(N) + ".eval";
+    EvalParams start;
+    if (!paramsPath.empty() && !start.load(paramsPath)) {
+        cerr << "cannot read weights from " << paramsPath << "\n";
+        return 2;
+    }
+
+    // 1. Self-play
+    auto t0 = chrono::steady_clock::now();
+    SelfPlayConfig play;
+    play.cols         = cols;
+    play.levels       = levels;
+    play.N            = N;
+    play.depth        = depth;
+    play.openingPlies = openingPlies;
+    play.seed         = seed;
+    play.eval         = start;
+    vector<Sample> data = playGames<Sample>(games, threads, [&play](int g) {
+        return playGame(play, g);
+    });
+    long long heldOut = count_if(data.begin(), data.end(), [](const Sample& x) { return x.heldOut; });
+    double playSec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    fprintf(stderr, "self-play: %d games, %zu positions in %.1f s\n", games, data.size(), playSec);
+
+    // 2. Fitting
+    t0 = chrono::steady_clock::now();
+    double w0[FEATURES], w[FEATURES];
+    toWeights(start, w0);
+    toWeights(start, w);
+    double K = fitK(data, w0, threads);
+    tune(data, w, K, epochs, threads);
+    EvalParams tuned = fromWeights(w);
+    toWeights(tuned, w);
+    double fitSec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    // 3. Weights file
+    if (!tuned.save(out)) {
+        cerr << "cannot write " << out << "\n";
+        return 1;
+    }
+
+    // 4. Report
+    printf("Evaluation tuning on %dx%d N=%d\n", cols, levels, N);
+    printf("self-play  %d games at depth %d, %d opening plies: %zu positions "
+           "(%lld held out), %.1f s on %d threads\n",
+           games, depth, openingPlies, data.size(), heldOut, playSec, threads);
+    printf("fit        K %.6g, %d Adam steps, %.1f s\n", K, epochs, fitSec);
+    printf("%-8s %7s %7s %7s %7s %7s %10s %10s\n", "weights", "square", "linear",
+           "empty", "threat", "tempo", "train mse", "held mse");
+    auto row = [&](const char* name, const EvalParams& p, const double* x) {
+        printf("%-8s %7d %7d %7d %7d %7d %10.5f %10.5f\n", name, p.square, p.linear,
+               p.empty, p.threat, p.tempo, meanError(data, x, K, false, threads),
+               meanError(data, x, K, true, threads));
+    };
+    row("start", start, w0);
+    row("tuned", tuned, w);
+    printf("written to %s\n", out.c_str());
+
+    if (matchGames > 0) {
+        ArenaConfig cfg;
+        cfg.cols       = cols;
+        cfg.levels     = levels;
+        cfg.N          = N;
+        cfg.games      = matchGames + matchGames % 2;
+        cfg.threads    = threads;
+        cfg.moveTimeMs = moveTimeMs;
+        cfg.seed       = seed;
+        auto factory = [](const char* name, const EvalParams& p) {
+            return [name, p] {
+                SearchConfig sc;
+                sc.eval = p;
+                return unique_ptr<Player>(new SmartPlayer(name, sc));
+            };
+        };
+        ArenaResult r = runArena(cfg, factory("tuned", tuned), factory("start", start),
+                                 [](const ArenaResult& p) {
+            fprintf(stderr, "\r+%d =%d -%d  elo %+.1f +/- %.1f   ",
+                    p.wins, p.draws, p.losses, p.elo, p.eloError);
+        });
+        fprintf(stderr, "\n");
+        printf("match      tuned vs start, %d games at %d ms/move: W/D/L %d/%d/%d  "
+               "score %.1f%%  elo %+.1f +/- %.1f (95%%)\n",
+               r.wins + r.draws + r.losses, moveTimeMs, r.wins, r.draws, r.losses,
+               100 * r.score, r.elo, r.eloError);
+    }
+    return 0;
+}